@@ -0,0 +1,73 @@
+// Measure the cost of matching vertex names against a regular expression,
+// comparing std::regex on every name with the literal prefilter followed by
+// std::regex or Boost.Regex. The optional number of jobs sets the threads
+// that the prefiltered searches are divided between.
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <regex>
+#include <string>
+#include <vector>
+#include "netlist_paths/Netlist.hpp"
+#include "netlist_paths/Options.hpp"
+
+using namespace netlist_paths;
+
+/// Time a query and return milliseconds per query.
+template<typename F>
+static double timeQuery(std::size_t iterations, std::size_t &numMatches, F query) {
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < iterations; i++) {
+    numMatches = query();
+  }
+  auto end = std::chrono::steady_clock::now();
+  std::chrono::duration<double, std::milli> elapsed = end - start;
+  return elapsed.count() / static_cast<double>(iterations);
+}
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0] << " <netlist.xml> <regex> [iterations] [jobs]\n";
+    return EXIT_FAILURE;
+  }
+  std::string pattern(argv[2]);
+  std::size_t iterations = argc > 3 ? std::stoul(argv[3]) : 10;
+  Netlist netlist(argv[1]);
+  if (argc > 4) {
+    Options::getInstance().setNumJobs(std::stoul(argv[4]));
+  }
+  auto vertices = netlist.getNamedVerticesPtr();
+  // The original search, running std::regex on every name.
+  std::regex nameRegex(pattern);
+  std::size_t scanMatches = 0, stdMatches = 0, boostMatches = 0;
+  auto scanTime = timeQuery(iterations, scanMatches, [&]() {
+    std::size_t count = 0;
+    for (auto vertex : vertices) {
+      auto &name = vertex->getName();
+      count += std::regex_search(name.begin(), name.end(), nameRegex);
+    }
+    return count;
+  });
+  Options::getInstance().setMatchRegex();
+  Options::getInstance().setRegexEngineStd();
+  auto stdTime = timeQuery(iterations, stdMatches, [&]() {
+    return netlist.getNamedVerticesPtr(pattern).size();
+  });
+  Options::getInstance().setRegexEngineBoost();
+  auto boostTime = timeQuery(iterations, boostMatches, [&]() {
+    return netlist.getNamedVerticesPtr(pattern).size();
+  });
+  if (scanMatches != stdMatches || scanMatches != boostMatches) {
+    std::cerr << "Mismatch in the number of matches: " << scanMatches << " "
+              << stdMatches << " " << boostMatches << "\n";
+    return EXIT_FAILURE;
+  }
+  std::cout << vertices.size() << " names, " << scanMatches << " matches, "
+            << iterations << " iterations, "
+            << Options::getInstance().getNumJobs() << " jobs\n";
+  std::cout << "std::regex scan:            " << scanTime << " ms/query\n";
+  std::cout << "prefilter and std::regex:   " << stdTime << " ms/query\n";
+  std::cout << "prefilter and Boost.Regex:  " << boostTime << " ms/query\n";
+  return EXIT_SUCCESS;
+}
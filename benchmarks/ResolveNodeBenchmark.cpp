@@ -0,0 +1,91 @@
+// Measure the cost of resolving XML element names to AstNode types, comparing
+// the perfect-hash table with the std::map lookup it replaced.
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <rapidxml-1.13/rapidxml.hpp>
+#include "netlist_paths/AstNode.hpp"
+#include "netlist_paths/MappedFile.hpp"
+
+using namespace netlist_paths;
+
+using XMLNode = rapidxml::xml_node<>;
+
+/// The original lookup, constructing a std::string for each name.
+static AstNode resolveNodeMap(const char *name) {
+  static std::map<std::string, AstNode> mappings;
+  if (mappings.empty()) {
+    for (auto &entry : AST_NODE_NAMES) {
+      mappings[std::string(entry.first)] = entry.second;
+    }
+  }
+  auto it = mappings.find(name);
+  return (it != mappings.end()) ? it->second : AstNode::INVALID;
+}
+
+static void collectNodes(XMLNode *node, std::vector<XMLNode*> &nodes) {
+  for (XMLNode *child = node->first_node();
+       child; child = child->next_sibling()) {
+    if (child->type() == rapidxml::node_element) {
+      nodes.push_back(child);
+      collectNodes(child, nodes);
+    }
+  }
+}
+
+/// Time a resolution function over all nodes and return nanoseconds per node.
+template<typename F>
+static double timeResolve(const std::vector<XMLNode*> &nodes,
+                          std::size_t iterations, F resolve) {
+  std::size_t checksum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < iterations; i++) {
+    for (auto node : nodes) {
+      checksum += static_cast<std::size_t>(resolve(node));
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  // Prevent the loop from being optimised away.
+  volatile std::size_t sink = checksum;
+  (void)sink;
+  std::chrono::duration<double, std::nano> elapsed = end - start;
+  return elapsed.count() / static_cast<double>(nodes.size() * iterations);
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <netlist.xml> [iterations]\n";
+    return EXIT_FAILURE;
+  }
+  std::size_t iterations = argc > 2 ? std::stoul(argv[2]) : 100;
+  MappedFile inputFile(argv[1]);
+  rapidxml::xml_document<> doc;
+  doc.parse<0>(inputFile.getData());
+  std::vector<XMLNode*> nodes;
+  collectNodes(&doc, nodes);
+  if (nodes.empty()) {
+    std::cerr << "No elements in " << argv[1] << "\n";
+    return EXIT_FAILURE;
+  }
+  // Check both methods agree.
+  for (auto node : nodes) {
+    if (resolveNodeMap(node->name()) !=
+        resolveNode(std::string_view(node->name(), node->name_size()))) {
+      std::cerr << "Mismatch resolving " << node->name() << "\n";
+      return EXIT_FAILURE;
+    }
+  }
+  auto mapTime = timeResolve(nodes, iterations, [](XMLNode *node) {
+      return resolveNodeMap(node->name()); });
+  auto hashTime = timeResolve(nodes, iterations, [](XMLNode *node) {
+      return resolveNode(std::string_view(node->name(), node->name_size())); });
+  std::cout << nodes.size() << " elements, " << iterations << " iterations\n";
+  std::cout << "std::map lookup:     " << mapTime << " ns/node\n";
+  std::cout << "perfect-hash lookup: " << hashTime << " ns/node\n";
+  return EXIT_SUCCESS;
+}
@@ -27,6 +27,7 @@ public:
   }
 
   const std::string getName() const { return name; }
+  const Location &getLocation() const { return location; }
   virtual size_t getWidth() const { return 0; }
   virtual ~DType() = default; // Make DType polymorphic to allow dynamic casts.
 
@@ -77,6 +78,10 @@ public:
   virtual size_t getWidth() const override {
     return ranged ? (left - right + 1) : 1;
   }
+
+  unsigned getLeft() const { return left; }
+  unsigned getRight() const { return right; }
+  bool isRanged() const { return ranged; }
 };
 
 /// Reference data type, wrapping a sub data type.
@@ -93,6 +98,7 @@ public:
       DType(name, location) {}
 
   void setSubDType(std::shared_ptr<DType> sdt) { subDType = sdt; }
+  const std::shared_ptr<DType> &getSubDType() const { return subDType; }
 
   virtual const std::string toString(const std::string suffix="") const override {
     return (boost::format("%s%s") % subDType->toString() % suffix).str();
@@ -121,6 +127,10 @@ public:
       DType(location), start(start), end(end), packed(packed) {}
 
   void setSubDType(std::shared_ptr<DType> sdt) { subDType = sdt; }
+  const std::shared_ptr<DType> &getSubDType() const { return subDType; }
+  size_t getStart() const { return start; }
+  size_t getEnd() const { return end; }
+  bool isPacked() const { return packed; }
 
   virtual const std::string toString(const std::string suffix="") const override {
     if (packed) {
@@ -158,6 +168,9 @@ public:
               std::shared_ptr<DType> sdt) :
       DType(name, location), subDType(sdt) {};
 
+  void setSubDType(std::shared_ptr<DType> sdt) { subDType = sdt; }
+  const std::shared_ptr<DType> &getSubDType() const { return subDType; }
+
   virtual size_t getWidth() const override {
     return subDType->getWidth();
   }
@@ -186,6 +199,8 @@ public:
     members.push_back(memberDType);
   }
 
+  const std::vector<MemberDType> &getMembers() const { return members; }
+
   virtual const std::string toString(const std::string suffix="") const override {
     return std::string("packed struct") + suffix;
   }
@@ -219,6 +234,8 @@ public:
     members.push_back(memberDType);
   }
 
+  const std::vector<MemberDType> &getMembers() const { return members; }
+
   virtual const std::string toString(const std::string suffix="") const override {
     return std::string("packed union") + suffix;
   }
@@ -264,6 +281,8 @@ public:
   void addItem(EnumItem item) { items.push_back(item); }
 
   void setSubDType(std::shared_ptr<DType> sdt) { subDType = sdt; }
+  const std::shared_ptr<DType> &getSubDType() const { return subDType; }
+  const std::vector<EnumItem> &getItems() const { return items; }
 
   virtual const std::string toString(const std::string suffix="") const override {
     return std::string("emum") + suffix;
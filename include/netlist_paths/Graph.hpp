@@ -2,15 +2,22 @@
 #define NETLIST_PATHS_GRAPH_HPP
 
 #include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 #include <boost/graph/adjacency_list.hpp>
-#include <boost/graph/filtered_graph.hpp>
 #include <boost/graph/graph_traits.hpp>
 #include <boost/tokenizer.hpp>
 #include "netlist_paths/DTypes.hpp"
 #include "netlist_paths/Edge.hpp"
 #include "netlist_paths/Options.hpp"
+#include "netlist_paths/ReachabilityMatrix.hpp"
 #include "netlist_paths/Vertex.hpp"
 
 namespace netlist_paths {
@@ -22,80 +29,294 @@ using InternalGraph = boost::adjacency_list<boost::vecS,
                                             Edge>;
 using VertexID = boost::graph_traits<InternalGraph>::vertex_descriptor;
 using EdgeID = boost::graph_traits<InternalGraph>::edge_descriptor;
-using ParentMap = std::map<VertexID, std::vector<VertexID>>;
 using VertexIDVec = std::vector<VertexID>;
 
-/// An edge predicate for the filtered graph.
-struct EdgePredicate {
+class Condensation;
+class QueryWorkspace;
+
+/// Edges of a CSRGraph are stored as the 32-bit ID of the adjacent vertex,
+/// with the top bit set when the edge is through a register.
+constexpr uint32_t CSR_THROUGH_REGISTER = 1U << 31;
+
+/// An immutable compressed sparse row representation of the edges of a
+/// netlist graph, used for all traversals once the graph has been built. The
+/// out edges of vertex v are outEdges[outOffsets[v]] up to
+/// outEdges[outOffsets[v+1]], in the order they were added to the graph, and
+/// the in edges are held in the same way. The arrays are either owned by the
+/// CSRGraph or are a view of arrays held elsewhere, such as in a netlist
+/// image.
+class CSRGraph {
+  std::vector<uint32_t> ownedOutOffsets;
+  std::vector<uint32_t> ownedOutEdges;
+  std::vector<uint32_t> ownedInOffsets;
+  std::vector<uint32_t> ownedInEdges;
+  std::size_t vertexCount;
+  std::size_t edgeCount;
+  const uint32_t *outOffsets;
+  const uint32_t *outEdges;
+  const uint32_t *inOffsets;
+  const uint32_t *inEdges;
+
+  bool isValid(const uint32_t *offsets, const uint32_t *edges) const;
 
-  const InternalGraph *graph;
+public:
+  /// Create an empty graph.
+  CSRGraph() :
+      vertexCount(0), edgeCount(0),
+      outOffsets(nullptr), outEdges(nullptr),
+      inOffsets(nullptr), inEdges(nullptr) {}
+
+  /// Create a view of arrays held elsewhere, which must outlive it.
+  CSRGraph(std::size_t numVertices,
+           std::size_t numEdges,
+           const uint32_t *outOffsets,
+           const uint32_t *outEdges,
+           const uint32_t *inOffsets,
+           const uint32_t *inEdges) :
+      vertexCount(numVertices), edgeCount(numEdges),
+      outOffsets(outOffsets), outEdges(outEdges),
+      inOffsets(inOffsets), inEdges(inEdges) {}
+
+  /// Create a graph that owns its arrays.
+  CSRGraph(std::vector<uint32_t> outOffsetsValue,
+           std::vector<uint32_t> outEdgesValue,
+           std::vector<uint32_t> inOffsetsValue,
+           std::vector<uint32_t> inEdgesValue) :
+      ownedOutOffsets(std::move(outOffsetsValue)),
+      ownedOutEdges(std::move(outEdgesValue)),
+      ownedInOffsets(std::move(inOffsetsValue)),
+      ownedInEdges(std::move(inEdgesValue)),
+      vertexCount(ownedOutOffsets.empty() ? 0 : ownedOutOffsets.size() - 1),
+      edgeCount(ownedOutEdges.size()),
+      outOffsets(ownedOutOffsets.data()), outEdges(ownedOutEdges.data()),
+      inOffsets(ownedInOffsets.data()), inEdges(ownedInEdges.data()) {}
+
+  // Moving the owned vectors keeps their storage, so the pointers remain
+  // valid, but copies would refer to the original arrays.
+  CSRGraph(const CSRGraph&) = delete;
+  CSRGraph &operator=(const CSRGraph&) = delete;
+  CSRGraph(CSRGraph&&) = default;
+  CSRGraph &operator=(CSRGraph&&) = default;
+
+  /// Return a view of the arrays of this graph.
+  CSRGraph view() const {
+    return CSRGraph(vertexCount, edgeCount, outOffsets, outEdges, inOffsets, inEdges);
+  }
 
-  EdgePredicate() {}
+  /// Encode an edge to a vertex.
+  static uint32_t encodeEdge(VertexID vertex, bool throughRegister) {
+    return static_cast<uint32_t>(vertex) |
+           (throughRegister ? CSR_THROUGH_REGISTER : 0);
+  }
 
-  EdgePredicate(const InternalGraph *graph) : graph(graph) {}
+  std::size_t numVertices() const { return vertexCount; }
+  std::size_t numEdges() const { return edgeCount; }
 
-  bool operator()(EdgeID edgeID) const {
-    // Include all edges if traversal of registers is enabled, otherwise only
-    // include edges that do not traverse a register.
-    if (Options::getInstance().shouldTraverseRegisters()) {
-      return true;
-    } else {
-      return !(*graph)[edgeID].isThroughRegister();
-    }
+  std::size_t outDegree(VertexID vertex) const {
+    return outOffsets[vertex+1] - outOffsets[vertex];
   }
-};
 
-/// A vertex predicate for the filtered graph.
-struct VertexPredicate {
-  const VertexIDVec *avoidPointIDs;
-
-  VertexPredicate() : avoidPointIDs(nullptr) {}
+  std::size_t inDegree(VertexID vertex) const {
+    return inOffsets[vertex+1] - inOffsets[vertex];
+  }
 
-  VertexPredicate(const VertexIDVec *avoidPointIDs) :
-      avoidPointIDs(avoidPointIDs) {}
+  /// Return the number of bytes used by the arrays.
+  std::size_t memoryUsage() const {
+    return (2 * (vertexCount + 1) + 2 * edgeCount) * sizeof(uint32_t);
+  }
 
-  /// Return true if the vertex should be excluded from the search.
-  bool operator()(VertexID vertexID) const {
-    if (!avoidPointIDs) {
-      return true;
-    } else {
-      return !std::binary_search(avoidPointIDs->begin(), avoidPointIDs->end(),
-                                 vertexID);
+  /// Return true if the offsets index the edges consistently and every edge
+  /// refers to a vertex of the graph, so that traversals stay in bounds.
+  bool isValid() const;
+
+  /// Call a function with the adjacent vertex of each out edge, or each in
+  /// edge if reverse is true, of a vertex, and whether that edge is through
+  /// a register.
+  template<typename Function>
+  void forEachEdge(VertexID vertex, bool reverse, Function function) const {
+    auto offsets = reverse ? inOffsets : outOffsets;
+    auto edges = reverse ? inEdges : outEdges;
+    for (auto i = offsets[vertex]; i < offsets[vertex+1]; i++) {
+      function(static_cast<VertexID>(edges[i] & ~CSR_THROUGH_REGISTER),
+               (edges[i] & CSR_THROUGH_REGISTER) != 0);
     }
   }
-};
 
-using FilteredInternalGraph = boost::filtered_graph<InternalGraph,
-                                                    EdgePredicate,
-                                                    VertexPredicate>;
+  /// Perform a depth-first search of the vertices reachable from a root
+  /// vertex, recording in a workspace the parent of each vertex in the search
+  /// tree or, if allPaths is set, the list of parents from every edge to it.
+  /// Edges through registers are excluded unless traversal of registers is
+  /// enabled.
+  ///
+  /// \param workspace     The workspace to record the search in.
+  /// \param root          The vertex to start the search from.
+  /// \param allPaths      Record all edges, rather than only tree edges.
+  /// \param reverse       Search the in edges of vertices, rather than out edges.
+  /// \param avoidPointIDs A sorted list of vertices to exclude, or null.
+  /// \param components    If not null, the component number of each vertex
+  ///                      from getComponents(), which limits a forward search
+  ///                      to vertices that can reach the component numbered
+  ///                      target, and a reverse search to vertices that can be
+  ///                      reached from it.
+  /// \param target        A component number, used with components.
+  void depthFirstSearch(QueryWorkspace &workspace,
+                        VertexID root,
+                        bool allPaths,
+                        bool reverse,
+                        const VertexIDVec *avoidPointIDs,
+                        const uint32_t *components=nullptr,
+                        uint32_t target=0) const;
+
+  /// Find the vertices reachable from a root vertex with a breadth-first
+  /// search, which are left in the workspace's first frontier in the order
+  /// they were found, starting with the root, and marked as visited. Edges
+  /// through registers are excluded unless traversal of registers is enabled.
+  ///
+  /// \param workspace The workspace to record the search in.
+  /// \param root      The vertex to start the search from.
+  /// \param reverse   Search the in edges of vertices, rather than out edges.
+  void findReachable(QueryWorkspace &workspace,
+                     VertexID root,
+                     bool reverse) const;
+
+  /// Find the strongly-connected components of the graph, excluding edges
+  /// through registers unless traverseRegisters is set. Components are
+  /// numbered in reverse topological order, so that every edge between two
+  /// components is from a higher number to a lower one.
+  ///
+  /// \param traverseRegisters Include edges through registers.
+  /// \param components        Set to the component number of each vertex.
+  ///
+  /// \returns The number of components.
+  std::size_t getComponents(bool traverseRegisters,
+                            std::vector<uint32_t> &components) const;
+
+  /// Search for a path from a start vertex to a finish vertex with a
+  /// bidirectional breadth-first search. The search alternates between a
+  /// forward frontier from the start and a reverse frontier from the finish,
+  /// expanding whichever has fewer edges to examine, and stops as soon as
+  /// they meet. The number of vertices explored is therefore bounded by the
+  /// smaller of the fan-out of the start and the fan-in of the finish.
+  ///
+  /// \param workspace     The workspace to record the search in.
+  /// \param start         The vertex to start the search from.
+  /// \param finish        The vertex to search for.
+  /// \param avoidPointIDs A sorted list of vertices to exclude, or null.
+  /// \param path          If not null, set to the vertices of the path from
+  ///                      start to finish, when one is found.
+  /// \param components    If not null, the component number of each vertex
+  ///                      from getComponents(), which limits the search to
+  ///                      the components between those of start and finish.
+  ///
+  /// \returns True if a path exists.
+  bool findPath(QueryWorkspace &workspace,
+                VertexID start,
+                VertexID finish,
+                const VertexIDVec *avoidPointIDs,
+                VertexIDVec *path,
+                const uint32_t *components=nullptr) const;
+
+  /// Count the paths from a root vertex to each vertex reachable from it,
+  /// without enumerating them. Paths do not repeat vertices, as with
+  /// searchAllPaths(). The strongly-connected components of the graph are
+  /// visited in topological order, and the count of a vertex is the sum of
+  /// the counts of its predecessors in earlier components, which takes time
+  /// linear in the size of the reachable part of the graph. The paths within
+  /// a component with more than one vertex, such as a port and its alias,
+  /// are enumerated. Counts saturate at UINT64_MAX, which is also the count
+  /// of any vertex on or downstream of a reachable loop in the logic, since
+  /// the number of paths through it is unbounded, or of a component with too
+  /// many paths within it to enumerate.
+  ///
+  /// \param workspace     The workspace to record the counts in, which are
+  ///                      valid for the vertices visited by the search.
+  /// \param root          The vertex to count paths from.
+  /// \param finish        If not the null vertex, paths do not continue
+  ///                      beyond this vertex, and the search is limited to
+  ///                      the components between those of root and finish.
+  /// \param reverse       Count paths along in edges, rather than out edges.
+  /// \param avoidPointIDs A sorted list of vertices to exclude, or null.
+  /// \param condensation  The condensation of the graph, with the current
+  ///                      setting of register traversal.
+  /// \param isLoop        Return true if a component is a loop in the logic.
+  void countPaths(QueryWorkspace &workspace,
+                  VertexID root,
+                  VertexID finish,
+                  bool reverse,
+                  const VertexIDVec *avoidPointIDs,
+                  const Condensation &condensation,
+                  const std::function<bool(uint32_t)> &isLoop) const;
+};
 
-/// A class representing a netlist graph.
+class ImageWriter;
+class NameIndex;
+class NetlistImage;
+class PathEnumerator;
+class ReachabilityIndex;
+class SnapshotReader;
+class SnapshotWriter;
+
+/// A class representing a netlist graph. The graph is built as a mutable
+/// adjacency list, which is then frozen into an array of vertices and a
+/// CSRGraph of the edges to answer queries. Alternatively, the graph is a
+/// read-only netlist image that is queried in place.
 class Graph {
 private:
   InternalGraph graph;
+  std::vector<Vertex> frozenVertices;
+  CSRGraph csr;
+  bool frozen;
   std::map<std::string, VertexID> aliasMap;
+  std::shared_ptr<const NetlistImage> image;
+  std::shared_ptr<const ReachabilityIndex> reachabilityIndex;
+  mutable std::shared_ptr<const Condensation> condensations[2];
+  mutable std::mutex condensationMutex;
+  mutable std::shared_ptr<const NameIndex> nameIndex;
+  mutable std::mutex nameIndexMutex;
+
+  bool isGraphType(VertexID vertex, VertexNetlistType graphType) const;
 
   bool vertexTypeMatch(VertexID vertex, VertexNetlistType graphType) const;
 
+  std::string_view getVertexName(VertexID vertex) const;
+
+  VertexID getAliasRegister(const std::string &name) const;
+
   bool isAliasPath(const VertexIDVec &waypointIDs) const;
 
+  std::shared_ptr<const Condensation> getCondensation() const;
+
+  bool isLogicLoop(const Condensation &condensation, uint32_t component) const;
+
+  std::shared_ptr<const NameIndex> getNameIndex() const;
+
   VertexIDVec getAdjacentVerticesOutEdges(VertexID vertex) const;
 
   VertexIDVec getAdjacentVerticesInEdges(VertexID vertex) const;
 
-  VertexIDVec determinePath(ParentMap &parentMap,
-                            VertexIDVec path,
-                            VertexID startVertexId,
-                            VertexID endVertexId) const;
+  VertexIDVec getVisitedPoints(const QueryWorkspace &workspace,
+                               VertexNetlistType graphType) const;
+
+  VertexIDVec determinePath(const QueryWorkspace &workspace,
+                            VertexID startVertex,
+                            VertexID endVertex) const;
+
+  void searchAllPaths(QueryWorkspace &workspace,
+                      const Condensation &condensation,
+                      VertexID startVertex,
+                      VertexID finishVertex,
+                      const VertexIDVec &avoidPointIDs) const;
+
+  void startPathWalk(QueryWorkspace &workspace,
+                     VertexID startVertex,
+                     VertexID finishVertex) const;
+
+  bool nextPath(QueryWorkspace &workspace, VertexID startVertex) const;
 
-  void determineAllPaths(ParentMap &parentMap,
-                         std::vector<VertexIDVec> &result,
-                         VertexIDVec path,
-                         VertexID startVertex,
-                         VertexID endVertex) const;
+  friend class PathEnumerator;
 
 public:
-  Graph() {}
+  Graph() : frozen(false) {}
 
   //===--------------------------------------------------------------------===//
   // Graph construction methods.
@@ -121,6 +342,11 @@ public:
     return boost::add_vertex(vertex, graph);
   }
 
+  /// Add a copy of a vertex to the graph.
+  VertexID addVertex(const Vertex &vertex) {
+    return boost::add_vertex(vertex, graph);
+  }
+
   /// Add an edge to the graph.
   void addEdge(VertexID src, VertexID dst) {
     boost::add_edge(src, dst, graph);
@@ -136,6 +362,25 @@ public:
     graph[vertex].setDirection(direction);
   }
 
+  /// Set the data type of the specified vertex.
+  void setVertexDType(VertexID vertex, std::shared_ptr<DType> dtype) {
+    graph[vertex].setDType(dtype);
+  }
+
+  /// Remove all vertices and edges from the graph.
+  void clear() {
+    graph.clear();
+    frozenVertices.clear();
+    csr = CSRGraph();
+    frozen = false;
+    aliasMap.clear();
+    image.reset();
+    reachabilityIndex.reset();
+    condensations[0].reset();
+    condensations[1].reset();
+    nameIndex.reset();
+  }
+
   /// Mark all variables that are aliases of registers.
   void markAliasRegisters();
 
@@ -145,6 +390,37 @@ public:
   /// Add additional edges to variable aliases.
   void updateVarAliases();
 
+  /// Convert the adjacency list into an array of vertices and a CSRGraph,
+  /// once the graph has been built. No further vertices or edges can be
+  /// added after this.
+  void freeze();
+
+  /// Return true if the graph has been frozen.
+  bool isFrozen() const { return frozen; }
+
+  /// Write the vertices, edges and aliases of the graph to a snapshot.
+  void writeSnapshot(SnapshotWriter &writer) const;
+
+  /// Replace the graph with the vertices, edges and aliases in a snapshot.
+  void readSnapshot(SnapshotReader &reader);
+
+  /// Write the vertices, edges and aliases of the graph to an image.
+  void writeImage(ImageWriter &writer) const;
+
+  /// Replace the graph with a netlist image, which is then used to answer
+  /// all queries.
+  void setImage(std::shared_ptr<const NetlistImage> netlistImage);
+
+  /// Return true if the graph is a netlist image.
+  bool isImage() const { return image != nullptr; }
+
+  /// Build an index of the reachability of the graph, with the current
+  /// setting of register traversal, which is then used to answer path
+  /// existence queries that have no avoid points.
+  ///
+  /// \returns The size of the index in bytes.
+  std::size_t buildReachabilityIndex();
+
   /// Perform some checks on the final graph.
   void checkGraph() const;
 
@@ -158,7 +434,8 @@ public:
   /// Return a list of vertices matching a VertexGraphType.
   VertexIDVec getVerticesByType(VertexNetlistType graphType) const;
 
-  /// Lookup a vertex by matching its name exactly.
+  /// Lookup a vertex by matching its name exactly. Once the graph is frozen,
+  /// names are looked up in a hash index, which is built on the first lookup.
   VertexID getVertexExact(const std::string &name,
                           VertexNetlistType graphType=VertexNetlistType::ANY) const;
 
@@ -170,6 +447,12 @@ public:
   VertexIDVec getVerticesWildcard(const std::string &pattern,
                                   VertexNetlistType graphType=VertexNetlistType::ANY) const;
 
+  /// Return a list of vertices in a scope of the hierarchy, which are those
+  /// whose names start with the scope followed by a dot, or all vertices if
+  /// the scope is empty.
+  VertexIDVec getVerticesUnderScope(const std::string &scope,
+                                    VertexNetlistType graphType=VertexNetlistType::ANY) const;
+
   /// Return a list of vertices that match the pattern.
   VertexIDVec getVertices(const std::string &pattern,
                           VertexNetlistType graphType=VertexNetlistType::ANY) const;
@@ -209,11 +492,16 @@ public:
   /// Return a list of paths to an end vertex.
   std::vector<VertexIDVec> getAllFanIn(VertexID endVertex) const;
 
-  /// Count the fanout from a start vertex.
-  size_t getfanOutDegree(VertexID startVertex);
+  /// Count the end points in the fan out of a start vertex.
+  size_t getfanOutDegree(VertexID startVertex) const;
+
+  /// Count the start points in the fan in of an end vertex.
+  size_t getFanInDegree(VertexID endVertex) const;
 
-  /// Count the fanin to an end vertex.
-  size_t getFanInDegree(VertexID endVertex);
+  /// Return true if there is a path between the specified waypoints, avoiding
+  /// the specified mid points.
+  bool pathExists(const VertexIDVec &waypointIDs,
+                  const VertexIDVec &avoidPointIDs) const;
 
   /// Return any path between the specified waypoints, avoiding the specified
   /// mid points.
@@ -225,20 +513,53 @@ public:
   std::vector<VertexIDVec> getAllPointToPoint(const VertexIDVec &waypoints,
                                               const VertexIDVec &avoidPointIDs) const;
 
+  /// Return the number of paths between the specified waypoints, avoiding
+  /// the specified mid points, which saturates at UINT64_MAX.
+  uint64_t countPaths(const VertexIDVec &waypointIDs,
+                      const VertexIDVec &avoidPointIDs) const;
+
+  /// Return the number of paths from a start vertex to each end point it
+  /// fans out to, in increasing order of end point.
+  std::vector<std::pair<VertexID, uint64_t>> countFanOutPaths(VertexID startVertex) const;
+
+  /// Return the number of paths to an end vertex from each start point that
+  /// fans in to it, in increasing order of start point.
+  std::vector<std::pair<VertexID, uint64_t>> countFanInPaths(VertexID finishVertex) const;
+
+  /// Return which of a set of start vertices reach which of a set of end
+  /// vertices, with the current setting of register traversal. The start
+  /// vertices are taken 64 at a time, with a bit for each one in a word for
+  /// each strongly-connected component of the graph, and the words are
+  /// propagated along the edges between components in topological order, so
+  /// each batch of start vertices takes a single pass over the condensed
+  /// graph.
+  ReachabilityMatrix getReachabilityMatrix(const VertexIDVec &startVertices,
+                                           const VertexIDVec &endVertices) const;
+
+  /// Return the loops in the graph, with the current setting of register
+  /// traversal. Each loop is the list of vertices of a strongly-connected
+  /// component that has more than one vertex or an edge to itself and
+  /// contains logic other than alias assignments, in increasing order, and
+  /// the loops are in topological order.
+  std::vector<VertexIDVec> getLoops() const;
+
   //===--------------------------------------------------------------------===//
   // Miscellaneous getters and setters.
   //===--------------------------------------------------------------------===//
 
-  const Vertex &getVertex(VertexID vertexId) const { return graph[vertexId]; }
+  const Vertex &getVertex(VertexID vertexId) const;
+
+  /// Return true if a vertex object belongs to this graph.
+  bool ownsVertex(const Vertex *vertex) const;
 
   Vertex* getVertexPtr(VertexID vertexId) const {
     // Remove the const cast to make it compatible with the boost::python wrappers.
-    return const_cast<Vertex*>(&(graph[vertexId]));
+    return const_cast<Vertex*>(&getVertex(vertexId));
   }
 
   VertexID nullVertex() const { return boost::graph_traits<InternalGraph>::null_vertex(); }
-  std::size_t numVertices() const { return boost::num_vertices(graph); }
-  std::size_t numEdges() const { return boost::num_edges(graph); }
+  std::size_t numVertices() const;
+  std::size_t numEdges() const;
 };
 
 } // End namespace.
@@ -1,8 +1,10 @@
 #ifndef NETLIST_PATHS_LOCATION_HPP
 #define NETLIST_PATHS_LOCATION_HPP
 
+#include <cstdint>
+#include <limits>
 #include <string>
-#include <memory>
+#include <vector>
 #include <boost/format.hpp>
 
 /// A class representing a source file.
@@ -24,49 +26,67 @@ public:
   const std::string &getLanguage() const { return language; }
 };
 
-/// A class representing a file location.
+/// A class representing a file location. The file is identified by its index
+/// in the source files of the netlist the location belongs to, so the file
+/// name is resolved with that list of files.
 class Location {
-  std::shared_ptr<File> file;
+  uint32_t fileIndex;
   unsigned startLine;
   unsigned startCol;
   unsigned endLine;
   unsigned endCol;
 
 public:
+  /// The index representing an unknown file.
+  static constexpr uint32_t NULL_INDEX = std::numeric_limits<uint32_t>::max();
 
   /// Default construct a file location object.
-  Location() : file(nullptr) {}
+  Location() :
+      fileIndex(NULL_INDEX),
+      startLine(0),
+      startCol(0),
+      endLine(0),
+      endCol(0) {}
 
   /// Construct a file location object, identifying a source-level entity.
   ///
-  /// \param file      A shared pointer to the file which this location is in.
+  /// \param fileIndex The index of the file this location is in, in the
+  ///                  source files of the netlist.
   /// \param startLine The line number of the start of the entity.
   /// \param startCol  The column number of the start of the entity.
   /// \param endLine   The line number of the end of the entity.
   /// \param endCol    The column number of the end of the entity.
-  Location(std::shared_ptr<File> file,
+  Location(uint32_t fileIndex,
            unsigned startLine,
            unsigned startCol,
            unsigned endLine,
            unsigned endCol) :
-      file(file),
+      fileIndex(fileIndex),
       startLine(startLine),
       startCol(startCol),
       endLine(endLine),
       endCol(endCol) {}
 
   /// Return the filename.
-  const std::string getFilename() const {
-    if (file) {
-      return file->getFilename();
+  ///
+  /// \param files The source files of the netlist.
+  const std::string getFilename(const std::vector<File> &files) const {
+    if (fileIndex < files.size()) {
+      return files[fileIndex].getFilename();
     } else {
       return "unknown";
     }
   }
 
+  uint32_t getFileIndex() const { return fileIndex; }
+  unsigned getStartLine() const { return startLine; }
+  unsigned getStartCol() const { return startCol; }
+  unsigned getEndLine() const { return endLine; }
+  unsigned getEndCol() const { return endCol; }
+
   /// Equality comparison
   friend bool operator== (const Location &a, const Location &b) {
-    return a.file == b.file &&
+    return a.fileIndex == b.fileIndex &&
            a.startLine == b.startLine &&
            a.startCol == b.startCol &&
            a.endLine == b.endLine &&
@@ -74,15 +94,15 @@ public:
   }
 
   /// Return a string representing the exact location (using all location details).
-  std::string getLocationStrExact() const {
+  std::string getLocationStrExact(const std::vector<File> &files) const {
     auto s = boost::format("%s %d:%d,%d:%d")
-               % getFilename() % startLine % startCol % endLine % endCol;
+               % getFilename(files) % startLine % startCol % endLine % endCol;
     return s.str();
   }
 
   /// Return a string representing a brief location (only filename and start line).
-  std::string getLocationStr() const {
-    auto s = boost::format("%s:%d") % getFilename() % startLine;
+  std::string getLocationStr(const std::vector<File> &files) const {
+    auto s = boost::format("%s:%d") % getFilename(files) % startLine;
     return s.str();
   }
 };
@@ -9,6 +9,7 @@
 #include "netlist_paths/Exception.hpp"
 #include "netlist_paths/Graph.hpp"
 #include "netlist_paths/Options.hpp"
+#include "netlist_paths/PathEnumerator.hpp"
 #include "netlist_paths/Waypoints.hpp"
 
 namespace netlist_paths {
@@ -71,14 +72,43 @@ class Netlist {
   /// Read a set of avoid points to constrain a path query.
   VertexIDVec readAvoidPoints(Waypoints waypoints) const;
 
-public:
-  Netlist() = delete;
+  Netlist() {}
 
+public:
   /// Construct a new netlist from an XML file.
   ///
   /// \param filename A path to the XML netlist file.
   Netlist(const std::string &filename);
 
+  /// Write the netlist to a binary snapshot file, which can be loaded much
+  /// faster than the XML it was read from.
+  ///
+  /// \param filename A path to the snapshot file.
+  void save(const std::string &filename) const;
+
+  /// Construct a netlist from a snapshot file written by save().
+  ///
+  /// \param filename A path to the snapshot file.
+  ///
+  /// \returns The netlist.
+  static std::unique_ptr<Netlist> load(const std::string &filename);
+
+  /// Write the netlist to a read-only image file. Unlike a snapshot, an image
+  /// is not read into memory when it is opened, but is queried directly from
+  /// a shared memory mapping of the file, so processes on the same host that
+  /// open the same image share one copy of it.
+  ///
+  /// \param filename A path to the image file.
+  void saveImage(const std::string &filename) const;
+
+  /// Construct a netlist that queries an image file written by saveImage().
+  /// The netlist cannot be saved again.
+  ///
+  /// \param filename A path to the image file.
+  ///
+  /// \returns The netlist.
+  static std::unique_ptr<Netlist> openImage(const std::string &filename);
+
   //===--------------------------------------------------------------------===//
   // Reporting of names and types.
   //===--------------------------------------------------------------------===//
@@ -108,6 +138,24 @@ public:
   /// \returns The width of the data type.
   size_t getDTypeWidth(const std::string &name) const;
 
+  /// Return the source location of a vertex, with the name of its file.
+  ///
+  /// \param vertex A vertex of the netlist.
+  ///
+  /// \returns A string with the filename and start line of the location.
+  std::string getLocationStr(const Vertex *vertex) const {
+    return vertex->getLocationStr(files);
+  }
+
+  /// Return true if a vertex object belongs to this netlist.
+  ///
+  /// \param vertex A vertex returned by a query of any netlist.
+  ///
+  /// \returns True if the vertex was returned by a query of this netlist.
+  bool ownsVertex(const Vertex *vertex) const {
+    return graph.ownsVertex(vertex);
+  }
+
   //===--------------------------------------------------------------------===//
   // Basic path querying.
   //===--------------------------------------------------------------------===//
@@ -161,6 +209,14 @@ public:
   /// \returns True if a path exists.
   bool pathExists(Waypoints waypoints) const;
 
+  /// Build an index of the reachability of the netlist, which answers
+  /// pathExists() queries without searching the graph. The index applies to
+  /// queries with the same setting of register traversal as when it was
+  /// built, and without avoid points. Other queries search the graph.
+  ///
+  /// \returns The size of the index in bytes.
+  size_t buildReachabilityIndex() { return graph.buildReachabilityIndex(); }
+
   /// Return any path between two points.
   ///
   /// \param waypoints A waypoints object constraining the path.
@@ -175,6 +231,76 @@ public:
   /// \returns All paths matching the waypoints, otherwise an empty vector.
   std::vector<std::vector<Vertex*> > getAllPaths(Waypoints waypoints) const;
 
+  /// Return an enumerator of all paths between two points, which produces
+  /// the same paths as getAllPaths() one at a time, without holding them all
+  /// in memory. The netlist must outlive the enumerator.
+  ///
+  /// \param waypoints A waypoints object constraining the path.
+  ///
+  /// \returns An enumerator of the paths matching the waypoints.
+  std::unique_ptr<PathEnumerator> getPathEnumerator(Waypoints waypoints) const;
+
+  /// Return which start points reach which end points, computed for all the
+  /// start points at once, which is much faster than determining the fan out
+  /// of each start point in turn.
+  ///
+  /// \param startPattern A pattern matching the start points, or all start
+  ///                     points if empty.
+  /// \param endPattern   A pattern matching the end points, or all end points
+  ///                     if empty.
+  ///
+  /// \returns A matrix with a row for each start point and a column for each
+  ///          end point.
+  ReachabilityMatrix getReachabilityMatrix(const std::string startPattern,
+                                           const std::string endPattern) const;
+
+  /// Return the number of end points in the fan out of a start point, which
+  /// is the number of paths getAllFanOut() returns, without determining the
+  /// paths.
+  ///
+  /// \param startName A pattern matching a start point.
+  ///
+  /// \returns The fan out degree of the start point.
+  size_t getFanOutDegree(const std::string startName) const;
+
+  /// Return the number of start points in the fan in of an end point, which
+  /// is the number of paths getAllFanIn() returns, without determining the
+  /// paths.
+  ///
+  /// \param endName A pattern matching an end point.
+  ///
+  /// \returns The fan in degree of the end point.
+  size_t getFanInDegree(const std::string endName) const;
+
+  /// Return the number of paths between two points, without enumerating
+  /// them, so that it takes linear time however many paths there are. Without
+  /// loops in the logic between the points, this is the number of paths
+  /// returned by getAllPaths(). If a combinational loop (or, when registers
+  /// are traversed, any loop) lies on a path between the points, the number
+  /// of paths is unbounded. Counts saturate at the maximum value of the type,
+  /// which also represents an unbounded count.
+  ///
+  /// \param waypoints A waypoints object constraining the path.
+  ///
+  /// \returns The number of paths matching the waypoints.
+  uint64_t countPaths(Waypoints waypoints) const;
+
+  /// Return the number of paths from a start point to each end point it fans
+  /// out to, counted as countPaths() does.
+  ///
+  /// \param startName A pattern matching a start point.
+  ///
+  /// \returns Pairs of an end point and the number of paths to it.
+  std::vector<std::pair<Vertex*, uint64_t> > countFanOutPaths(const std::string startName) const;
+
+  /// Return the number of paths to an end point from each start point that
+  /// fans in to it, counted as countPaths() does.
+  ///
+  /// \param endName A pattern matching an end point.
+  ///
+  /// \returns Pairs of a start point and the number of paths from it.
+  std::vector<std::pair<Vertex*, uint64_t> > countFanInPaths(const std::string endName) const;
+
   /// Return a vector of paths fanning out from a particular start point.
   ///
   /// \param startName A pattern matching a start point.
@@ -189,6 +315,17 @@ public:
   /// \returns All paths fanning in to the matching endpoint, otherwise an empty vector.
   std::vector<std::vector<Vertex*> > getAllFanIn(const std::string endName) const;
 
+  /// Return the loops in the netlist, which are the strongly-connected
+  /// components of its graph with more than one vertex, or with an edge from
+  /// a vertex to itself, apart from those formed only by the aliases of a
+  /// variable. Unless registers are traversed, these are the combinational
+  /// loops of the netlist.
+  ///
+  /// \returns The vertices of each loop, with the loops in topological order.
+  std::vector<std::vector<Vertex*> > getLoops() const {
+    return createVertexPtrVecVec(graph.getLoops());
+  }
+
   //===--------------------------------------------------------------------===//
   // Netlist access.
   //===--------------------------------------------------------------------===//
@@ -233,6 +370,17 @@ public:
     return createVertexPtrVec(graph.getVertices(pattern, VertexNetlistType::REG));
   }
 
+  /// Return a vector of pointers to the named vertices in a scope of the
+  /// hierarchy, such as the registers and ports of an instance, which are
+  /// found without a scan of the whole netlist.
+  ///
+  /// \param scope The hierarchical name of the scope, such as "top.core0".
+  ///
+  /// \returns A vector of pointers to Vertex objects.
+  std::vector<Vertex*> getVerticesUnderScope(const std::string scope) const {
+    return createVertexPtrVec(graph.getVerticesUnderScope(scope, VertexNetlistType::IS_NAMED));
+  }
+
   /// Write a dot-file represenation of the netlist graph to a file.
   ///
   /// \param outputFilename The file to write the dot output to.
@@ -16,28 +16,39 @@ enum class MatchType {
   WILDCARD
 };
 
+enum class RegexEngine {
+  STD,
+  BOOST
+};
+
 /// A class encapsulating options.
 class Options {
 
   bool debugMode;
   bool verboseMode;
   MatchType matchType;
+  RegexEngine regexEngine;
   bool ignoreHierarchyMarkers;
   bool matchOneVertex;
   bool traverseRegisters;
   bool restrictStartPoints;
   bool restrictEndPoints;
+  bool streamXML;
+  size_t numJobs;
 
 public:
   bool isMatchExact() const { return matchType == MatchType::EXACT; }
   bool isMatchRegex() const { return matchType == MatchType::REGEX; }
   bool isMatchWildcard() const { return matchType == MatchType::WILDCARD; }
+  bool isRegexEngineBoost() const { return regexEngine == RegexEngine::BOOST; }
   bool isMatchOneVertex() const { return matchOneVertex; }
   bool isMatchAnyVertex() const { return !matchOneVertex; }
   bool shouldIgnoreHierarchyMarkers() const { return ignoreHierarchyMarkers; }
   bool shouldTraverseRegisters() const { return traverseRegisters; }
   bool isRestrictStartPoints() const { return restrictStartPoints; }
   bool isRestrictEndPoints() const { return restrictEndPoints; }
+  bool shouldStreamXML() const { return streamXML; }
+  size_t getNumJobs() const { return numJobs; }
   bool isVerboseMode() const { return verboseMode; }
   bool isDebugMode() const { return debugMode; }
 
@@ -50,6 +61,14 @@ public:
   /// Set matching to be exact.
   void setMatchExact() { matchType = MatchType::EXACT; }
 
+  /// Set regular expressions to be matched by std::regex, with the
+  /// ECMAScript grammar.
+  void setRegexEngineStd() { regexEngine = RegexEngine::STD; }
+
+  /// Set regular expressions to be matched by Boost.Regex, with the Perl
+  /// grammar, which is much faster than std::regex.
+  void setRegexEngineBoost() { regexEngine = RegexEngine::BOOST; }
+
   /// Set matching to ignore (true) or respect (false) hierarchy markers (only
   /// with wildcard or regular expression matching modes). Note that hierarchy
   /// markers are '.', '/' and '_'.
@@ -76,6 +95,19 @@ public:
   /// variable.
   void setRestrictEndPoints(bool value) { restrictEndPoints = value; }
 
+  /// Enable or disable streaming of the XML netlist. When set to true, the
+  /// netlist is read incrementally from a bounded buffer without building a
+  /// document tree of the whole file, reducing peak memory usage. A streamed
+  /// netlist is read by a single thread, whatever the number of jobs, and a
+  /// warning is logged if more than one is set.
+  void setStreamXML(bool value) { streamXML = value; }
+
+  /// Set the number of threads used to build the netlist graph and to scan its
+  /// vertices for names matching a pattern. The graph and the matches are
+  /// identical to those of a single thread. Streamed netlists are always read
+  /// by a single thread, and small graphs are always scanned by one.
+  void setNumJobs(size_t value) { numJobs = value > 0 ? value : 1; }
+
   /// Enable verbose output.
   void setVerbose() {
     boost::log::core::get()->set_filter(boost::log::trivial::severity >= boost::log::trivial::info);
@@ -109,11 +141,14 @@ private:
       debugMode(false),
       verboseMode(false),
       matchType(MatchType::EXACT),
+      regexEngine(RegexEngine::STD),
       ignoreHierarchyMarkers(false),
       matchOneVertex(true),
       traverseRegisters(false),
       restrictStartPoints(true),
-      restrictEndPoints(true) {
+      restrictEndPoints(true),
+      streamXML(false),
+      numJobs(1) {
     // Setup logging.
     boost::log::add_console_log(std::clog, boost::log::keywords::format = "%Severity%: %Message%");
     setQuiet();
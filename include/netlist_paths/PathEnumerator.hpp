@@ -0,0 +1,94 @@
+#ifndef NETLIST_PATHS_PATH_ENUMERATOR_HPP
+#define NETLIST_PATHS_PATH_ENUMERATOR_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <vector>
+#include "netlist_paths/Graph.hpp"
+#include "netlist_paths/Vertex.hpp"
+
+namespace netlist_paths {
+
+/// An enumeration of all the paths between a sequence of waypoints, which
+/// produces one path at a time, on demand, rather than collecting them all.
+/// Each segment of the path between adjacent waypoints is searched once, and
+/// its paths are then walked in turn, with the combinations of segment paths
+/// visited in the same order as Netlist::getAllPaths() returns them. Beyond
+/// the searches, memory use is proportional to the length of a path, not the
+/// number of paths.
+///
+/// The enumerator refers to the graph it was created from, which must
+/// outlive it.
+class PathEnumerator {
+  const Graph &graph;
+  VertexIDVec waypointIDs;
+  std::vector<std::unique_ptr<QueryWorkspace>> segments;
+  std::vector<Vertex*> path;
+  bool aliasPath;
+  bool started;
+  bool finished;
+
+  bool advance();
+
+public:
+  /// Search for the paths between waypoints.
+  ///
+  /// \param graph         The graph to search.
+  /// \param waypointIDs   The vertices the paths pass through, in order.
+  /// \param avoidPointIDs A sorted list of vertices the paths avoid.
+  PathEnumerator(const Graph &graph,
+                 VertexIDVec waypointIDs,
+                 const VertexIDVec &avoidPointIDs);
+
+  ~PathEnumerator();
+
+  PathEnumerator(const PathEnumerator&) = delete;
+  PathEnumerator &operator=(const PathEnumerator&) = delete;
+
+  /// Move to the next path.
+  ///
+  /// \returns False if there are no more paths.
+  bool next();
+
+  /// Return the current path, after a call to next() has returned true.
+  const std::vector<Vertex*> &getPath() const { return path; }
+
+  /// An input iterator over the remaining paths.
+  class iterator {
+    PathEnumerator *enumerator;
+
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = std::vector<Vertex*>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+
+    explicit iterator(PathEnumerator *enumerator=nullptr) :
+        enumerator(enumerator) {}
+
+    reference operator*() const { return enumerator->getPath(); }
+    pointer operator->() const { return &enumerator->getPath(); }
+
+    iterator &operator++() {
+      if (!enumerator->next()) {
+        enumerator = nullptr;
+      }
+      return *this;
+    }
+
+    bool operator==(const iterator &other) const { return enumerator == other.enumerator; }
+    bool operator!=(const iterator &other) const { return enumerator != other.enumerator; }
+  };
+
+  /// Move to the next path and return an iterator to it, so that the
+  /// enumerator can be used in a range-based for loop.
+  iterator begin() { return iterator(next() ? this : nullptr); }
+
+  iterator end() { return iterator(); }
+};
+
+} // End netlist_paths namespace.
+
+#endif // NETLIST_PATHS_PATH_ENUMERATOR_HPP
@@ -0,0 +1,94 @@
+#ifndef NETLIST_PATHS_REACHABILITY_MATRIX_HPP
+#define NETLIST_PATHS_REACHABILITY_MATRIX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "netlist_paths/Vertex.hpp"
+
+namespace netlist_paths {
+
+class Graph;
+
+/// A matrix of which start points reach which end points, with a row for
+/// each start point and a column for each end point. It is computed for all
+/// the start points at once, by Graph::getReachabilityMatrix(), rather than
+/// with a search from each one.
+///
+/// The matrix is held as a compressed bitmap in both row and column order.
+/// Each row is a list of the non-zero 64-bit words of its bits, each with the
+/// index of the block of 64 columns it holds, and similarly for each column,
+/// so that a sparse matrix takes space proportional to the number of words
+/// with bits set, and any row or column can be read without decompressing the
+/// others.
+class ReachabilityMatrix {
+  /// A list of the non-zero words of each row or column of the matrix.
+  struct Bitmap {
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> blocks;
+    std::vector<uint64_t> words;
+
+    bool test(std::size_t line, std::size_t index) const;
+    std::vector<std::size_t> getIndices(std::size_t line) const;
+  };
+
+  /// A non-zero word of a row or column.
+  struct Entry {
+    uint32_t line;
+    uint32_t block;
+    uint64_t word;
+  };
+
+  std::vector<Vertex*> startPoints;
+  std::vector<Vertex*> endPoints;
+  Bitmap rows;
+  Bitmap columns;
+
+  ReachabilityMatrix() = default;
+
+  static Bitmap groupEntries(const std::vector<Entry> &entries,
+                             std::size_t numLines);
+
+  void setColumns(const std::vector<Entry> &columnEntries);
+
+  friend class Graph;
+
+public:
+  /// Return the number of start points, which is the number of rows.
+  std::size_t numStartPoints() const { return startPoints.size(); }
+
+  /// Return the number of end points, which is the number of columns.
+  std::size_t numEndPoints() const { return endPoints.size(); }
+
+  /// Return the start point of each row.
+  const std::vector<Vertex*> &getStartPoints() const { return startPoints; }
+
+  /// Return the end point of each column.
+  const std::vector<Vertex*> &getEndPoints() const { return endPoints; }
+
+  /// Return true if a start point reaches an end point.
+  ///
+  /// \param startIndex The row of the start point.
+  /// \param endIndex   The column of the end point.
+  bool reaches(std::size_t startIndex, std::size_t endIndex) const;
+
+  /// Return the end points that a start point reaches, in column order.
+  ///
+  /// \param startIndex The row of the start point.
+  std::vector<Vertex*> getRow(std::size_t startIndex) const;
+
+  /// Return the start points that reach an end point, in row order.
+  ///
+  /// \param endIndex The column of the end point.
+  std::vector<Vertex*> getColumn(std::size_t endIndex) const;
+
+  /// Return the number of pairs of a start point and an end point it reaches.
+  std::size_t count() const;
+
+  /// Return the number of bytes used by the compressed bitmaps.
+  std::size_t memoryUsage() const;
+};
+
+} // End netlist_paths namespace.
+
+#endif // NETLIST_PATHS_REACHABILITY_MATRIX_HPP
@@ -1,59 +1,242 @@
 #ifndef NETLIST_PATHS_UTILITIES_HPP
 #define NETLIST_PATHS_UTILITIES_HPP
 
+#include <cctype>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
 namespace netlist_paths {
 
-/// Wildcard pattern matching.
+/// A wildcard pattern, which is compiled once to be matched against many
+/// names.
 ///  * matches zero or more characters.
 ///  ? matches one character.
-/// Algorithm from:
-///   https://www.codeproject.com/Articles/188256/A-Simple-Wildcard-Matching-Function
-///
-/// \param text    The text to match.
-/// \param pattern The wildcard pattern to match.
 ///
-/// \returns True if the wildcard pattern matches the text.
-bool wildcardMatch(const char *text, const char *pattern) {
-  while (*pattern != '\0') {
-    if (*pattern == '*') {
-      // Ignore the * and check for matches against the remaining pattern and text.
-      if (wildcardMatch(text, pattern+1)) {
-        return true;
-      }
-      // Try matching the * against the next largest suffix of the text.
-      if (wildcardMatch(text+1, pattern)) {
-        return true;
-      }
-      // No matches.
-      return false;
-    } else if (*pattern == '?') {
-      // Match any character, providing there is one, then advance pattern and text.
-      if (*text == '\0') {
+/// The pattern is split at each * into segments of literal characters and
+/// ?s. The first segment must match at the start of the text and the last
+/// segment at the end, and each segment between them is matched at its
+/// leftmost position after the one before. Taking the leftmost position is
+/// always safe, since the * that follows can absorb any characters, so there
+/// is no backtracking, and matching takes O(n*m) time at worst for a text of
+/// length n and a pattern of length m. Segments without ?s are located with
+/// std::string_view::find(), which uses the vectorised memchr() and memcmp()
+/// of the C library.
+class WildcardPattern {
+  struct Segment {
+    std::string chars;
+    bool hasAnyChar;
+  };
+
+  std::vector<Segment> segments;
+  bool hasStar;
+  std::size_t minLength;
+  std::string literalPrefix;
+
+  /// Return true if a segment matches the text at a position.
+  static bool matchAt(std::string_view text, std::size_t pos, const Segment &segment) {
+    if (!segment.hasAnyChar) {
+      return text.compare(pos, segment.chars.size(), segment.chars) == 0;
+    }
+    for (std::size_t i = 0; i < segment.chars.size(); i++) {
+      if (segment.chars[i] != '?' && segment.chars[i] != text[pos+i]) {
         return false;
       }
-      pattern++;
-      text++;
-    } else {
-      // Compare two characters, if they match advance the pattern and text.
-      if (*pattern != *text) {
+    }
+    return true;
+  }
+
+  /// Return the leftmost position from which a segment matches the text, or
+  /// npos.
+  static std::size_t find(std::string_view text, std::size_t from, const Segment &segment) {
+    if (!segment.hasAnyChar) {
+      return text.find(segment.chars, from);
+    }
+    for (auto pos = from; pos + segment.chars.size() <= text.size(); pos++) {
+      if (matchAt(text, pos, segment)) {
+        return pos;
+      }
+    }
+    return std::string_view::npos;
+  }
+
+public:
+  /// Compile a wildcard pattern.
+  ///
+  /// \param pattern                The wildcard pattern.
+  /// \param ignoreHierarchyMarkers Match any character with each '/', '.'
+  ///                               and '_' in the pattern, as ? does.
+  explicit WildcardPattern(std::string_view pattern,
+                           bool ignoreHierarchyMarkers=false) :
+      segments(1, Segment{std::string(), false}), hasStar(false), minLength(0) {
+    bool inPrefix = true;
+    for (auto c : pattern) {
+      if (ignoreHierarchyMarkers && (c == '/' || c == '.' || c == '_')) {
+        c = '?';
+      }
+      if (c == '*') {
+        segments.push_back(Segment{std::string(), false});
+        hasStar = true;
+        inPrefix = false;
+        continue;
+      }
+      if (c == '?') {
+        segments.back().hasAnyChar = true;
+        inPrefix = false;
+      } else if (inPrefix) {
+        literalPrefix.push_back(c);
+      }
+      segments.back().chars.push_back(c);
+      minLength++;
+    }
+  }
+
+  /// Return the literal characters at the start of the pattern, which every
+  /// matching text starts with.
+  const std::string &getLiteralPrefix() const { return literalPrefix; }
+
+  /// Return true if the pattern matches the whole of a text.
+  bool match(std::string_view text) const {
+    if (text.size() < minLength) {
+      return false;
+    }
+    if (!hasStar) {
+      return text.size() == minLength && matchAt(text, 0, segments.front());
+    }
+    if (!matchAt(text, 0, segments.front())) {
+      return false;
+    }
+    auto pos = segments.front().chars.size();
+    for (std::size_t i = 1; i + 1 < segments.size(); i++) {
+      if (segments[i].chars.empty()) {
+        continue;
+      }
+      pos = find(text, pos, segments[i]);
+      if (pos == std::string_view::npos) {
         return false;
       }
-      pattern++;
-      text++;
+      pos += segments[i].chars.size();
+    }
+    auto &last = segments.back();
+    return text.size() - pos >= last.chars.size() &&
+           matchAt(text, text.size() - last.chars.size(), last);
+  }
+};
+
+/// Return substrings that any text matched by a regular expression must
+/// contain, so that texts without them can be rejected with a fast substring
+/// search before the regular expression is run. Only literal characters
+/// outside groups and character classes are considered, and a character
+/// followed by a quantifier that allows zero repetitions is dropped. The
+/// analysis is conservative: patterns with alternation or (? constructs,
+/// which can change how the rest of the pattern matches, have no required
+/// substrings.
+///
+/// \param pattern The regular expression, in the ECMAScript or Perl
+///                grammar.
+///
+/// \returns The required substrings, which may be empty.
+inline std::vector<std::string> getRequiredRegexLiterals(std::string_view pattern) {
+  std::vector<std::string> literals;
+  if (pattern.find('|') != std::string_view::npos ||
+      pattern.find("(?") != std::string_view::npos) {
+    return literals;
+  }
+  std::string literal;
+  auto endLiteral = [&]() {
+    if (!literal.empty()) {
+      literals.push_back(literal);
+      literal.clear();
+    }
+  };
+  int depth = 0;
+  for (std::size_t i = 0; i < pattern.size(); i++) {
+    auto c = pattern[i];
+    if (c == '\\' && i + 1 < pattern.size()) {
+      auto escaped = pattern[++i];
+      if (!std::isalnum(static_cast<unsigned char>(escaped))) {
+        if (depth == 0) {
+          literal.push_back(escaped);
+        }
+        continue;
+      }
+      // Escaped letters and digits are classes, assertions, references or
+      // character codes, which can run on into the letters, digits or braces
+      // that follow, so skip those too.
+      while (i + 1 < pattern.size() &&
+             std::isalnum(static_cast<unsigned char>(pattern[i + 1]))) {
+        i++;
+      }
+      if (i + 1 < pattern.size() && pattern[i + 1] == '{') {
+        while (i < pattern.size() && pattern[i] != '}') {
+          i++;
+        }
+      }
+      endLiteral();
+    } else if (c == '[') {
+      // Skip the class, in which a leading ] is literal and the bracketed
+      // [:class:], [.collating.] and [=equivalence=] forms can contain ].
+      i++;
+      if (i < pattern.size() && pattern[i] == '^') {
+        i++;
+      }
+      if (i < pattern.size() && pattern[i] == ']') {
+        i++;
+      }
+      while (i < pattern.size() && pattern[i] != ']') {
+        if (pattern[i] == '\\') {
+          i++;
+        } else if (pattern[i] == '[' && i + 1 < pattern.size() &&
+                   (pattern[i + 1] == ':' || pattern[i + 1] == '.' ||
+                    pattern[i + 1] == '=')) {
+          char terminator[] = {pattern[i + 1], ']', '\0'};
+          auto end = pattern.find(terminator, i + 2);
+          if (end == std::string_view::npos) {
+            // Malformed, so leave it to the regex to report.
+            return {};
+          }
+          i = end + 1;
+        }
+        i++;
+      }
+      endLiteral();
+    } else if (c == '(') {
+      depth++;
+      endLiteral();
+    } else if (c == ')') {
+      depth--;
+      endLiteral();
+    } else if (c == '*' || c == '?' || c == '{') {
+      // The preceding character can be absent.
+      if (!literal.empty()) {
+        literal.pop_back();
+      }
+      endLiteral();
+      if (c == '{') {
+        while (i < pattern.size() && pattern[i] != '}') {
+          i++;
+        }
+      }
+    } else if (c == '+' || c == '.' || c == '^' || c == '$') {
+      endLiteral();
+    } else if (depth == 0) {
+      literal.push_back(c);
     }
   }
-  // Match only if the pattern and text have ended.
-  return *text == '\0' && *pattern == '\0';
+  endLiteral();
+  return literals;
 }
 
-/// Wildcard pattern matching.
+/// Wildcard pattern matching of a single text. To match many texts against
+/// the same pattern, compile it once with WildcardPattern.
 ///
 /// \param text    The text to match.
 /// \param pattern The wildcard pattern to match.
 ///
 /// \returns True if the wildcard pattern matches the text.
-bool wildcardMatch(const std::string &text, const std::string &pattern) {
-  return wildcardMatch(text.c_str(), pattern.c_str());
+inline bool wildcardMatch(std::string_view text, std::string_view pattern) {
+  return WildcardPattern(pattern).match(text);
 }
 
 } // End namespace.
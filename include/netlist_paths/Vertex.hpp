@@ -228,6 +228,29 @@ public:
       top(determineIsTop(name)),
       deleted(false) {}
 
+  /// Construct a vertex with all of its attributes, such as when it is read
+  /// from a snapshot.
+  Vertex(VertexAstType type,
+         VertexDirection direction,
+         Location location,
+         std::shared_ptr<DType> dtype,
+         const std::string &name,
+         bool isParam,
+         const std::string &paramValue,
+         bool publicVisibility,
+         bool top,
+         bool deleted) :
+      astType(type),
+      direction(direction),
+      location(location),
+      dtype(dtype),
+      name(name),
+      isParam(isParam),
+      paramValue(paramValue),
+      publicVisibility(publicVisibility),
+      top(top),
+      deleted(deleted) {}
+
   /// Copy constructor.
   Vertex(const Vertex &v) :
       astType(v.astType),
@@ -236,6 +259,8 @@ public:
       dtype(v.dtype),
       name(v.name),
       isParam(v.isParam),
+      paramValue(v.paramValue),
+      publicVisibility(v.publicVisibility),
       top(v.top),
       deleted(v.deleted) {}
 
@@ -476,6 +501,7 @@ public:
   void setSrcRegAlias() { astType = VertexAstType::SRC_REG_ALIAS; }
   void setDstRegAlias() { astType = VertexAstType::DST_REG_ALIAS; }
   void setDirection(VertexDirection dir) { direction = dir; }
+  void setDType(std::shared_ptr<DType> newDType) { dtype = newDType; }
 
   VertexAstType getAstType() const { return astType; }
   VertexDirection getDirection() const { return direction; }
@@ -484,12 +510,17 @@ public:
     // Remove the const cast to make it compatible with the boost::python wrappers.
     return const_cast<DType*>(dtype.get());
   }
-  const std::string getName() const { return name; }
+  const std::string &getName() const { return name; }
+  const std::string &getParamValue() const { return paramValue; }
+  const Location &getLocation() const { return location; }
+  const std::shared_ptr<DType> &getDType() const { return dtype; }
   const std::string getAstTypeStr() const { return getVertexAstTypeStr(astType); }
   const std::string getSimpleAstTypeStr() const { return getSimpleVertexAstTypeStr(astType); }
   const std::string getDirStr() const { return getVertexDirectionStr(direction); }
   const std::string getDTypeStr() const { return dtype != nullptr ? dtype->toString() : "-"; }
-  const std::string getLocationStr() const { return location.getLocationStr(); }
+  const std::string getLocationStr(const std::vector<File> &files) const {
+    return location.getLocationStr(files);
+  }
   bool isDeleted() const { return deleted; }
 };
 
@@ -0,0 +1,140 @@
+#ifndef NETLIST_PATHS_AST_NODE_HPP
+#define NETLIST_PATHS_AST_NODE_HPP
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include <utility>
+
+namespace netlist_paths {
+
+enum class AstNode {
+  ALWAYS,
+  ALWAYS_PUBLIC,
+  ASSIGN,
+  ASSIGN_ALIAS,
+  ASSIGN_DLY,
+  ASSIGN_W,
+  BASIC_DTYPE,
+  CONST,
+  CONT_ASSIGN,
+  C_FUNC,
+  ENUM,
+  IFACE_REF_DTYPE,
+  INITIAL,
+  INSTANCE,
+  INTF_REF,
+  MEMBER_DTYPE,
+  MODULE,
+  PACKED_ARRAY,
+  RANGE,
+  REF_DTYPE,
+  SCOPE,
+  SEN_GATE,
+  SEN_ITEM,
+  STRUCT_DTYPE,
+  TOP_SCOPE,
+  TYPEDEF,
+  TYPE_TABLE,
+  UNION_DTYPE,
+  UNPACKED_ARRAY,
+  VAR,
+  VAR_REF,
+  VAR_SCOPE,
+  INVALID
+};
+
+/// XML element names and their corresponding AstNode types.
+constexpr std::pair<std::string_view, AstNode> AST_NODE_NAMES[] = {
+    { "always",           AstNode::ALWAYS },
+    { "alwayspublic",     AstNode::ALWAYS_PUBLIC },
+    { "assign",           AstNode::ASSIGN },
+    { "assignalias",      AstNode::ASSIGN_ALIAS },
+    { "assigndly",        AstNode::ASSIGN_DLY },
+    { "assignw",          AstNode::ASSIGN_W },
+    { "basicdtype",       AstNode::BASIC_DTYPE },
+    { "cfunc",            AstNode::C_FUNC },
+    { "const",            AstNode::CONST },
+    { "contassign",       AstNode::CONT_ASSIGN },
+    { "enumdtype",        AstNode::ENUM },
+    { "ifacerefdtype",    AstNode::IFACE_REF_DTYPE },
+    { "initial",          AstNode::INITIAL },
+    { "instance",         AstNode::INSTANCE },
+    { "intfref",          AstNode::INTF_REF },
+    { "memberdtype",      AstNode::MEMBER_DTYPE },
+    { "module",           AstNode::MODULE },
+    { "packarraydtype",   AstNode::PACKED_ARRAY },
+    { "refdtype",         AstNode::REF_DTYPE },
+    { "scope",            AstNode::SCOPE },
+    { "sengate",          AstNode::SEN_GATE },
+    { "senitem",          AstNode::SEN_ITEM },
+    { "structdtype",      AstNode::STRUCT_DTYPE },
+    { "topscope",         AstNode::TOP_SCOPE },
+    { "typedef",          AstNode::TYPEDEF },
+    { "typetable",        AstNode::TYPE_TABLE },
+    { "uniondtype",       AstNode::UNION_DTYPE },
+    { "unpackarraydtype", AstNode::UNPACKED_ARRAY },
+    { "var",              AstNode::VAR },
+    { "varref",           AstNode::VAR_REF },
+    { "varscope",         AstNode::VAR_SCOPE },
+};
+
+/// The number of slots in the AstNode name hash table.
+constexpr std::size_t AST_NODE_TABLE_SIZE = 64;
+
+/// Hash an element name using only its length and its first and last
+/// characters. The multipliers are chosen so that the hash is perfect
+/// (collision free) over AST_NODE_NAMES, which is checked below.
+constexpr std::size_t hashAstNodeName(std::string_view name) {
+  return (name.size() +
+          6 * static_cast<unsigned char>(name.front()) +
+          27 * static_cast<unsigned char>(name.back())) % AST_NODE_TABLE_SIZE;
+}
+
+/// Build a table mapping each hash value to an index of AST_NODE_NAMES, or -1
+/// if no name has that hash. A collision is marked with -2.
+constexpr std::array<int, AST_NODE_TABLE_SIZE> makeAstNodeTable() {
+  std::array<int, AST_NODE_TABLE_SIZE> table{};
+  for (auto &slot : table) {
+    slot = -1;
+  }
+  for (std::size_t i = 0; i < std::size(AST_NODE_NAMES); i++) {
+    auto &slot = table[hashAstNodeName(AST_NODE_NAMES[i].first)];
+    slot = slot == -1 ? static_cast<int>(i) : -2;
+  }
+  return table;
+}
+
+constexpr std::array<int, AST_NODE_TABLE_SIZE> AST_NODE_TABLE = makeAstNodeTable();
+
+constexpr bool isAstNodeTablePerfect() {
+  for (auto slot : AST_NODE_TABLE) {
+    if (slot == -2) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static_assert(isAstNodeTablePerfect(), "AstNode name hash has collisions");
+
+/// Convert an element name into an AstNode type.
+constexpr AstNode resolveNode(std::string_view name) {
+  if (name.empty()) {
+    return AstNode::INVALID;
+  }
+  auto index = AST_NODE_TABLE[hashAstNodeName(name)];
+  if (index >= 0 && AST_NODE_NAMES[index].first == name) {
+    return AST_NODE_NAMES[index].second;
+  }
+  return AstNode::INVALID;
+}
+
+static_assert(resolveNode("varref") == AstNode::VAR_REF &&
+              resolveNode("unpackarraydtype") == AstNode::UNPACKED_ARRAY &&
+              resolveNode("vars") == AstNode::INVALID,
+              "unexpected AstNode resolution");
+
+} // End netlist_paths namespace.
+
+#endif // NETLIST_PATHS_AST_NODE_HPP
@@ -0,0 +1,82 @@
+#include <utility>
+#include "netlist_paths/Condensation.hpp"
+
+using namespace netlist_paths;
+
+/// Group values into lists by key with a counting sort, so that each list
+/// keeps the order of its values.
+static void groupByKey(const std::vector<std::pair<uint32_t, uint32_t>> &pairs,
+                       std::size_t numKeys,
+                       std::vector<uint32_t> &offsets,
+                       std::vector<uint32_t> &values) {
+  offsets.assign(numKeys + 1, 0);
+  for (auto &pair : pairs) {
+    offsets[pair.first + 1]++;
+  }
+  for (std::size_t key = 0; key < numKeys; key++) {
+    offsets[key + 1] += offsets[key];
+  }
+  values.resize(pairs.size());
+  std::vector<uint32_t> next(offsets.begin(), offsets.end() - 1);
+  for (auto &pair : pairs) {
+    values[next[pair.first]++] = pair.second;
+  }
+}
+
+/// Each step is a single pass over the vertices or edges of the graph, so the
+/// condensation is built in linear time.
+Condensation::Condensation(const CSRGraph &graph, bool traverseRegisters) :
+    traverseRegisters(traverseRegisters) {
+  numComponents = graph.getComponents(traverseRegisters, components);
+  // Group the vertices by component.
+  std::vector<std::pair<uint32_t, uint32_t>> pairs;
+  pairs.reserve(graph.numVertices());
+  for (VertexID vertex = 0; vertex < graph.numVertices(); vertex++) {
+    pairs.emplace_back(components[vertex], static_cast<uint32_t>(vertex));
+  }
+  groupByKey(pairs, numComponents, memberOffsets, members);
+  // Collect the edges out of each component in turn, stamping each adjacent
+  // component with the current one to drop duplicate edges, and noting the
+  // components whose vertices have edges to themselves.
+  constexpr uint32_t NONE = UINT32_MAX;
+  std::vector<uint32_t> stamps(numComponents, NONE);
+  std::vector<bool> selfEdge(numComponents, false);
+  pairs.clear();
+  successorOffsets.reserve(numComponents + 1);
+  for (uint32_t component = 0; component < numComponents; component++) {
+    successorOffsets.push_back(static_cast<uint32_t>(successors.size()));
+    for (auto i = memberOffsets[component]; i < memberOffsets[component+1]; i++) {
+      VertexID vertex = members[i];
+      graph.forEachEdge(vertex, false, [&](VertexID next, bool throughRegister) {
+        if (throughRegister && !traverseRegisters) {
+          return;
+        }
+        auto nextComponent = components[next];
+        if (next == vertex) {
+          selfEdge[component] = true;
+        } else if (nextComponent != component && stamps[nextComponent] != component) {
+          stamps[nextComponent] = component;
+          successors.push_back(nextComponent);
+          pairs.emplace_back(nextComponent, component);
+        }
+      });
+    }
+  }
+  successorOffsets.push_back(static_cast<uint32_t>(successors.size()));
+  groupByKey(pairs, numComponents, predecessorOffsets, predecessors);
+  // Components are numbered in reverse topological order.
+  for (auto component = numComponents; component-- > 0;) {
+    if (memberOffsets[component+1] - memberOffsets[component] > 1 ||
+        selfEdge[component]) {
+      loops.push_back(static_cast<uint32_t>(component));
+    }
+  }
+}
+
+std::size_t Condensation::memoryUsage() const {
+  return (components.size() +
+          memberOffsets.size() + members.size() +
+          successorOffsets.size() + successors.size() +
+          predecessorOffsets.size() + predecessors.size() +
+          loops.size()) * sizeof(uint32_t);
+}
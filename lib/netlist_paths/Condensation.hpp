@@ -0,0 +1,82 @@
+#ifndef NETLIST_PATHS_CONDENSATION_HPP
+#define NETLIST_PATHS_CONDENSATION_HPP
+
+#include <cstdint>
+#include <vector>
+#include "netlist_paths/Graph.hpp"
+
+namespace netlist_paths {
+
+/// The condensation of a graph: its strongly-connected components and the
+/// DAG of the edges between them. Components are numbered in reverse
+/// topological order, as by CSRGraph::getComponents(), so a vertex can only
+/// reach vertices in components with the same or a lower number. A component
+/// with more than one vertex, or with an edge from its vertex to itself, is a
+/// loop.
+///
+/// The condensation reflects whether edges through registers were traversed
+/// when it was built. Without them, every loop is combinational.
+class Condensation {
+  bool traverseRegisters;
+  std::size_t numComponents;
+  std::vector<uint32_t> components;
+  std::vector<uint32_t> memberOffsets;
+  std::vector<uint32_t> members;
+  std::vector<uint32_t> successorOffsets;
+  std::vector<uint32_t> successors;
+  std::vector<uint32_t> predecessorOffsets;
+  std::vector<uint32_t> predecessors;
+  std::vector<uint32_t> loops;
+
+public:
+  /// Condense a graph.
+  ///
+  /// \param graph             The graph to condense.
+  /// \param traverseRegisters Include edges through registers.
+  Condensation(const CSRGraph &graph, bool traverseRegisters);
+
+  /// Return true if the condensation was built with edges through registers.
+  bool isTraverseRegisters() const { return traverseRegisters; }
+
+  /// Return the number of strongly-connected components in the graph.
+  std::size_t getNumComponents() const { return numComponents; }
+
+  /// Return the component number of each vertex.
+  const std::vector<uint32_t> &getComponents() const { return components; }
+
+  /// Return the component number of a vertex.
+  uint32_t getComponent(VertexID vertex) const { return components[vertex]; }
+
+  /// Return the vertices of a component, in increasing order.
+  VertexIDVec getMembers(uint32_t component) const {
+    return VertexIDVec(members.begin() + memberOffsets[component],
+                       members.begin() + memberOffsets[component+1]);
+  }
+
+  /// Call a function with each component adjacent to a component in the DAG,
+  /// following edges backwards if reverse is true. Each adjacent component
+  /// is visited once.
+  template<typename Function>
+  void forEachAdjacent(uint32_t component, bool reverse, Function function) const {
+    auto &offsets = reverse ? predecessorOffsets : successorOffsets;
+    auto &adjacent = reverse ? predecessors : successors;
+    for (auto i = offsets[component]; i < offsets[component+1]; i++) {
+      function(adjacent[i]);
+    }
+  }
+
+  std::size_t numAdjacent(uint32_t component, bool reverse) const {
+    auto &offsets = reverse ? predecessorOffsets : successorOffsets;
+    return offsets[component+1] - offsets[component];
+  }
+
+  /// Return the components that are loops, in topological order.
+  const std::vector<uint32_t> &getLoops() const { return loops; }
+
+  /// Return the number of bytes used by the condensation.
+  std::size_t memoryUsage() const;
+};
+
+} // End netlist_paths namespace.
+
+#endif // NETLIST_PATHS_CONDENSATION_HPP
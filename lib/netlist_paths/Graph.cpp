@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <memory>
@@ -10,50 +11,447 @@
 #include <regex>
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/filesystem.hpp>
-#include <boost/graph/depth_first_search.hpp>
 #include <boost/graph/graphviz.hpp>
 #include <boost/graph/iteration_macros.hpp>
-#include <boost/graph/reverse_graph.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/log/trivial.hpp>
+#include <boost/regex.hpp>
 #include <boost/tokenizer.hpp>
+#include "netlist_paths/Condensation.hpp"
 #include "netlist_paths/Exception.hpp"
 #include "netlist_paths/Graph.hpp"
+#include "netlist_paths/NameIndex.hpp"
+#include "netlist_paths/NetlistImage.hpp"
 #include "netlist_paths/Options.hpp"
+#include "netlist_paths/QueryWorkspace.hpp"
+#include "netlist_paths/ReachabilityIndex.hpp"
+#include "netlist_paths/Snapshot.hpp"
+#include "netlist_paths/ThreadPool.hpp"
 #include "netlist_paths/Utilities.hpp"
 
 using namespace netlist_paths;
 
-class DfsVisitor : public boost::default_dfs_visitor {
-private:
-  ParentMap &parentMap;
-  bool allPaths;
-public:
-  DfsVisitor(ParentMap &parentMap, bool allPaths) :
-      parentMap(parentMap), allPaths(allPaths) {}
-  // Visit only the edges of the DFS graph.
-  template<typename Edge, typename Graph>
-  void tree_edge(Edge edge, const Graph &graph) const {
-    if (!allPaths) {
-      VertexID src, dst;
-      src = boost::source(edge, graph);
-      dst = boost::target(edge, graph);
-      parentMap[dst].push_back(src);
-    }
-    return;
-  }
-  // Visit all edges of a vertex.
-  template<typename Edge, typename Graph>
-  void examine_edge(Edge edge, const Graph &graph) const {
+//===----------------------------------------------------------------------===//
+// CSRGraph
+//===----------------------------------------------------------------------===//
+
+bool CSRGraph::isValid(const uint32_t *offsets, const uint32_t *edges) const {
+  if (offsets[0] != 0 || offsets[vertexCount] != edgeCount) {
+    return false;
+  }
+  for (std::size_t vertex = 0; vertex < vertexCount; vertex++) {
+    if (offsets[vertex] > offsets[vertex+1]) {
+      return false;
+    }
+  }
+  for (std::size_t edge = 0; edge < edgeCount; edge++) {
+    if ((edges[edge] & ~CSR_THROUGH_REGISTER) >= vertexCount) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool CSRGraph::isValid() const {
+  if (vertexCount == 0) {
+    return edgeCount == 0;
+  }
+  return vertexCount < CSR_THROUGH_REGISTER &&
+         isValid(outOffsets, outEdges) &&
+         isValid(inOffsets, inEdges);
+}
+
+/// The search visits vertices and edges in the same order as
+/// boost::depth_first_search from a root vertex, but stops once the vertices
+/// reachable from the root have been visited. Since edges only lead to
+/// components with the same or a lower number, excluding vertices by
+/// component removes whole subtrees of the search, and the order in which the
+/// remaining vertices and edges are visited is unchanged.
+void CSRGraph::depthFirstSearch(QueryWorkspace &workspace,
+                                VertexID root,
+                                bool allPaths,
+                                bool reverse,
+                                const VertexIDVec *avoidPointIDs,
+                                const uint32_t *components,
+                                uint32_t target) const {
+  auto traverseRegisters = Options::getInstance().shouldTraverseRegisters();
+  auto offsets = reverse ? inOffsets : outOffsets;
+  auto edges = reverse ? inEdges : outEdges;
+  auto isAvoided = [avoidPointIDs](VertexID vertex) {
+    return avoidPointIDs &&
+           std::binary_search(avoidPointIDs->begin(), avoidPointIDs->end(), vertex);
+  };
+  auto isExcluded = [=](VertexID vertex) {
+    return components &&
+           (reverse ? components[vertex] > target : components[vertex] < target);
+  };
+  workspace.reset(vertexCount);
+  auto &stack = workspace.stack;
+  workspace.visit(0, root, QueryWorkspace::NONE);
+  stack.emplace_back(root, offsets[root]);
+  while (!stack.empty()) {
+    auto vertex = stack.back().first;
+    auto edgeIndex = stack.back().second;
+    if (edgeIndex == offsets[vertex+1]) {
+      stack.pop_back();
+      continue;
+    }
+    stack.back().second++;
+    auto edge = edges[edgeIndex];
+    auto next = static_cast<VertexID>(edge & ~CSR_THROUGH_REGISTER);
+    if (((edge & CSR_THROUGH_REGISTER) && !traverseRegisters) ||
+        isExcluded(next) || isAvoided(next)) {
+      continue;
+    }
+    if (!workspace.isVisited(0, next)) {
+      workspace.visit(0, next, static_cast<uint32_t>(vertex));
+      stack.emplace_back(next, offsets[next]);
+    }
     if (allPaths) {
-      VertexID src, dst;
-      src = boost::source(edge, graph);
-      dst = boost::target(edge, graph);
-      parentMap[dst].push_back(src);
+      workspace.addParent(next, vertex);
+    }
+  }
+}
+
+bool CSRGraph::findPath(QueryWorkspace &workspace,
+                        VertexID start,
+                        VertexID finish,
+                        const VertexIDVec *avoidPointIDs,
+                        VertexIDVec *path,
+                        const uint32_t *components) const {
+  if (start == finish) {
+    if (path) {
+      *path = {start};
+    }
+    return true;
+  }
+  // Any path lies within the components numbered from that of the finish to
+  // that of the start, so the search can skip the rest of the graph.
+  uint32_t lowComponent = 0;
+  uint32_t highComponent = UINT32_MAX;
+  if (components) {
+    lowComponent = components[finish];
+    highComponent = components[start];
+    if (highComponent < lowComponent) {
+      return false;
+    }
+  }
+  auto isAvoided = [avoidPointIDs](VertexID vertex) {
+    return avoidPointIDs &&
+           std::binary_search(avoidPointIDs->begin(), avoidPointIDs->end(), vertex);
+  };
+  // The start is searched from even if it is avoided, but the finish cannot
+  // be reached if it is.
+  if (isAvoided(finish)) {
+    return false;
+  }
+  auto traverseRegisters = Options::getInstance().shouldTraverseRegisters();
+  auto nullVertex = boost::graph_traits<InternalGraph>::null_vertex();
+  // The parent of each vertex in the forward search is its predecessor on the
+  // path from the start, and in the reverse search its successor on the path
+  // to the finish.
+  workspace.reset(vertexCount);
+  auto &frontiers = workspace.frontiers;
+  auto &nextFrontier = workspace.nextFrontier;
+  workspace.visit(0, start, QueryWorkspace::NONE);
+  workspace.visit(1, finish, QueryWorkspace::NONE);
+  frontiers[0].push_back(start);
+  frontiers[1].push_back(finish);
+  auto frontierEdges = [this](const std::vector<VertexID> &frontier, bool reverse) {
+    std::size_t count = 0;
+    for (auto vertex : frontier) {
+      count += reverse ? inDegree(vertex) : outDegree(vertex);
+    }
+    return count;
+  };
+  VertexID meeting = nullVertex;
+  while (meeting == nullVertex &&
+         !frontiers[0].empty() && !frontiers[1].empty()) {
+    // Expand one level of the cheaper frontier.
+    auto side = frontierEdges(frontiers[1], true) < frontierEdges(frontiers[0], false) ? 1 : 0;
+    nextFrontier.clear();
+    for (auto vertex : frontiers[side]) {
+      forEachEdge(vertex, side == 1, [&](VertexID next, bool throughRegister) {
+        if (meeting != nullVertex ||
+            (throughRegister && !traverseRegisters) ||
+            workspace.isVisited(side, next) ||
+            (components && (components[next] < lowComponent ||
+                            components[next] > highComponent)) ||
+            (next != start && isAvoided(next))) {
+          return;
+        }
+        workspace.visit(side, next, static_cast<uint32_t>(vertex));
+        if (workspace.isVisited(1 - side, next)) {
+          meeting = next;
+        }
+        nextFrontier.push_back(next);
+      });
+      if (meeting != nullVertex) {
+        break;
+      }
+    }
+    frontiers[side].swap(nextFrontier);
+  }
+  if (meeting == nullVertex) {
+    return false;
+  }
+  if (path) {
+    path->clear();
+    for (auto vertex = meeting; vertex != start; vertex = workspace.getParent(0, vertex)) {
+      path->push_back(vertex);
+    }
+    path->push_back(start);
+    std::reverse(path->begin(), path->end());
+    for (auto vertex = meeting; vertex != finish;) {
+      vertex = workspace.getParent(1, vertex);
+      path->push_back(vertex);
+    }
+  }
+  return true;
+}
+
+void CSRGraph::findReachable(QueryWorkspace &workspace,
+                             VertexID root,
+                             bool reverse) const {
+  auto traverseRegisters = Options::getInstance().shouldTraverseRegisters();
+  workspace.reset(vertexCount);
+  auto &reachable = workspace.frontiers[0];
+  workspace.visit(0, root, QueryWorkspace::NONE);
+  reachable.push_back(root);
+  for (std::size_t i = 0; i < reachable.size(); i++) {
+    forEachEdge(reachable[i], reverse, [&](VertexID next, bool throughRegister) {
+      if ((throughRegister && !traverseRegisters) ||
+          workspace.isVisited(0, next)) {
+        return;
+      }
+      workspace.visit(0, next, QueryWorkspace::NONE);
+      reachable.push_back(next);
+    });
+  }
+}
+
+/// The count of a vertex in a component without a cycle is the sum of the
+/// counts from its predecessors in earlier components. Within a component
+/// with a cycle, the paths from each vertex that is entered from an earlier
+/// component are enumerated, since a path can only enter a component once.
+void CSRGraph::countPaths(QueryWorkspace &workspace,
+                          VertexID root,
+                          VertexID finish,
+                          bool reverse,
+                          const VertexIDVec *avoidPointIDs,
+                          const Condensation &condensation,
+                          const std::function<bool(uint32_t)> &isLoop) const {
+  // The number of steps of the enumeration of the paths in a component,
+  // beyond which the counts of its vertices saturate.
+  constexpr std::size_t MAX_COMPONENT_STEPS = 1 << 20;
+  auto traverseRegisters = Options::getInstance().shouldTraverseRegisters();
+  auto nullVertex = boost::graph_traits<InternalGraph>::null_vertex();
+  auto offsets = reverse ? inOffsets : outOffsets;
+  auto edges = reverse ? inEdges : outEdges;
+  auto &components = condensation.getComponents();
+  auto isAvoided = [avoidPointIDs](VertexID vertex) {
+    return avoidPointIDs &&
+           std::binary_search(avoidPointIDs->begin(), avoidPointIDs->end(), vertex);
+  };
+  uint32_t lowComponent = 0;
+  uint32_t highComponent = UINT32_MAX;
+  if (finish != nullVertex) {
+    lowComponent = std::min(components[root], components[finish]);
+    highComponent = std::max(components[root], components[finish]);
+  }
+  // Return the vertex that a path can follow an edge to, or the null vertex.
+  auto getPathEdgeTarget = [&](uint32_t edge) {
+    auto next = static_cast<VertexID>(edge & ~CSR_THROUGH_REGISTER);
+    if (((edge & CSR_THROUGH_REGISTER) && !traverseRegisters) ||
+        next == root ||
+        components[next] < lowComponent ||
+        components[next] > highComponent ||
+        isAvoided(next)) {
+      return nullVertex;
+    }
+    return next;
+  };
+  auto add = [](uint64_t a, uint64_t b) {
+    return a > UINT64_MAX - b ? UINT64_MAX : a + b;
+  };
+  // Find the reachable vertices, whose counts hold the number of paths into
+  // them from other components until their component is counted.
+  workspace.reset(vertexCount);
+  if (workspace.counts.size() < vertexCount) {
+    workspace.counts.resize(vertexCount);
+  }
+  auto &reachable = workspace.frontiers[0];
+  auto &counts = workspace.counts;
+  workspace.visit(0, root, QueryWorkspace::NONE);
+  counts[root] = 1;
+  reachable.push_back(root);
+  for (std::size_t i = 0; i < reachable.size(); i++) {
+    auto vertex = reachable[i];
+    if (vertex == finish) {
+      continue;
+    }
+    for (auto j = offsets[vertex]; j < offsets[vertex+1]; j++) {
+      auto next = getPathEdgeTarget(edges[j]);
+      if (next != nullVertex && !workspace.isVisited(0, next)) {
+        workspace.visit(0, next, QueryWorkspace::NONE);
+        counts[next] = 0;
+        reachable.push_back(next);
+      }
+    }
+  }
+  // Components are numbered in reverse topological order.
+  std::sort(reachable.begin(), reachable.end(), [&](VertexID a, VertexID b) {
+    return reverse ? components[a] < components[b] : components[a] > components[b];
+  });
+  auto &stack = workspace.stack;
+  std::vector<uint64_t> entryCounts;
+  for (std::size_t first = 0; first < reachable.size();) {
+    auto component = components[reachable[first]];
+    auto last = first + 1;
+    while (last < reachable.size() && components[reachable[last]] == component) {
+      last++;
+    }
+    if (last - first > 1) {
+      // Enumerate the paths within the component from each vertex entered
+      // from an earlier component. A path can return to a vertex on it
+      // through a cycle of port or alias edges, which is not a loop in the
+      // logic and is not followed, but the count of a path through a loop is
+      // unbounded.
+      entryCounts.clear();
+      for (auto i = first; i < last; i++) {
+        entryCounts.push_back(counts[reachable[i]]);
+        counts[reachable[i]] = 0;
+      }
+      auto loop = isLoop(component);
+      std::size_t steps = 0;
+      bool saturate = false;
+      for (auto i = first; i < last && !saturate; i++) {
+        auto entryCount = entryCounts[i - first];
+        if (entryCount == 0) {
+          continue;
+        }
+        auto push = [&](VertexID vertex) {
+          counts[vertex] = add(counts[vertex], entryCount);
+          workspace.setOnPath(vertex, true);
+          stack.emplace_back(vertex, offsets[vertex]);
+        };
+        push(reachable[i]);
+        while (!stack.empty()) {
+          auto vertex = stack.back().first;
+          auto edgeIndex = stack.back().second;
+          if (vertex == finish || edgeIndex == offsets[vertex+1]) {
+            workspace.setOnPath(vertex, false);
+            stack.pop_back();
+            continue;
+          }
+          stack.back().second++;
+          auto next = getPathEdgeTarget(edges[edgeIndex]);
+          if (next == nullVertex || components[next] != component) {
+            continue;
+          }
+          if (workspace.isOnPath(next)) {
+            saturate = saturate || loop;
+          } else {
+            saturate = saturate || ++steps > MAX_COMPONENT_STEPS;
+            if (!saturate) {
+              push(next);
+            }
+          }
+          if (saturate) {
+            for (auto &entry : stack) {
+              workspace.setOnPath(entry.first, false);
+            }
+            stack.clear();
+          }
+        }
+      }
+      if (saturate) {
+        for (auto i = first; i < last; i++) {
+          counts[reachable[i]] = UINT64_MAX;
+        }
+      }
+    }
+    // Pass the counts on to the later components.
+    for (auto i = first; i < last; i++) {
+      auto vertex = reachable[i];
+      if (vertex == finish) {
+        continue;
+      }
+      for (auto j = offsets[vertex]; j < offsets[vertex+1]; j++) {
+        auto next = getPathEdgeTarget(edges[j]);
+        if (next != nullVertex && components[next] != component) {
+          counts[next] = add(counts[next], counts[vertex]);
+        }
+      }
+    }
+    first = last;
+  }
+}
+
+/// This is an iterative version of Tarjan's algorithm, which emits each
+/// component after all the components reachable from it.
+std::size_t CSRGraph::getComponents(bool traverseRegisters,
+                                    std::vector<uint32_t> &components) const {
+  constexpr uint32_t NONE = UINT32_MAX;
+  std::vector<uint32_t> index(vertexCount, NONE);
+  std::vector<uint32_t> lowLink(vertexCount);
+  std::vector<bool> onStack(vertexCount);
+  std::vector<uint32_t> componentStack;
+  std::vector<std::pair<uint32_t, uint32_t>> callStack;
+  components.assign(vertexCount, NONE);
+  uint32_t nextIndex = 0;
+  uint32_t numComponents = 0;
+  auto push = [&](uint32_t vertex) {
+    index[vertex] = lowLink[vertex] = nextIndex++;
+    componentStack.push_back(vertex);
+    onStack[vertex] = true;
+    callStack.emplace_back(vertex, outOffsets[vertex]);
+  };
+  for (uint32_t root = 0; root < vertexCount; root++) {
+    if (index[root] != NONE) {
+      continue;
+    }
+    push(root);
+    while (!callStack.empty()) {
+      auto vertex = callStack.back().first;
+      auto edgeIndex = callStack.back().second;
+      if (edgeIndex < outOffsets[vertex+1]) {
+        callStack.back().second++;
+        auto edge = outEdges[edgeIndex];
+        if ((edge & CSR_THROUGH_REGISTER) && !traverseRegisters) {
+          continue;
+        }
+        auto next = edge & ~CSR_THROUGH_REGISTER;
+        if (index[next] == NONE) {
+          push(next);
+        } else if (onStack[next]) {
+          lowLink[vertex] = std::min(lowLink[vertex], index[next]);
+        }
+        continue;
+      }
+      callStack.pop_back();
+      if (!callStack.empty()) {
+        auto parent = callStack.back().first;
+        lowLink[parent] = std::min(lowLink[parent], lowLink[vertex]);
+      }
+      if (lowLink[vertex] == index[vertex]) {
+        uint32_t member;
+        do {
+          member = componentStack.back();
+          componentStack.pop_back();
+          onStack[member] = false;
+          components[member] = numComponents;
+        } while (member != vertex);
+        numComponents++;
+      }
     }
-    return;
   }
-};
+  return numComponents;
+}
+
+//===----------------------------------------------------------------------===//
+// Graph
+//===----------------------------------------------------------------------===//
 
 /// Get all vertices connected by out edges from vertex.
 VertexIDVec Graph::getAdjacentVerticesOutEdges(VertexID vertex) const {
@@ -179,23 +577,247 @@ void Graph::updateVarAliases() {
   }
 }
 
+/// The out edges and in edges of each vertex keep their order in the
+/// adjacency list, which determines the order of traversals.
+void Graph::freeze() {
+  auto numVertices = boost::num_vertices(graph);
+  auto numEdges = boost::num_edges(graph);
+  if (numVertices >= CSR_THROUGH_REGISTER || numEdges >= QueryWorkspace::FOUND) {
+    throw Exception("netlist is too large");
+  }
+  std::vector<uint32_t> outOffsets, outEdges, inOffsets, inEdges;
+  outOffsets.reserve(numVertices + 1);
+  inOffsets.reserve(numVertices + 1);
+  outEdges.reserve(numEdges);
+  inEdges.reserve(numEdges);
+  frozenVertices.reserve(numVertices);
+  BGL_FORALL_VERTICES(v, graph, InternalGraph) {
+    outOffsets.push_back(static_cast<uint32_t>(outEdges.size()));
+    inOffsets.push_back(static_cast<uint32_t>(inEdges.size()));
+    BGL_FORALL_OUTEDGES(v, e, graph, InternalGraph) {
+      outEdges.push_back(CSRGraph::encodeEdge(boost::target(e, graph),
+                                              graph[e].isThroughRegister()));
+    }
+    BGL_FORALL_INEDGES(v, e, graph, InternalGraph) {
+      inEdges.push_back(CSRGraph::encodeEdge(boost::source(e, graph),
+                                             graph[e].isThroughRegister()));
+    }
+    frozenVertices.push_back(std::move(graph[v]));
+  }
+  outOffsets.push_back(static_cast<uint32_t>(outEdges.size()));
+  inOffsets.push_back(static_cast<uint32_t>(inEdges.size()));
+  // Release the adjacency list.
+  InternalGraph().swap(graph);
+  csr = CSRGraph(std::move(outOffsets), std::move(outEdges),
+                 std::move(inOffsets), std::move(inEdges));
+  frozen = true;
+  BOOST_LOG_TRIVIAL(debug) << boost::format("Froze graph with %d vertices and %d edges in %d bytes")
+                                % csr.numVertices() % csr.numEdges() % csr.memoryUsage();
+}
+
+void Graph::writeSnapshot(SnapshotWriter &writer) const {
+  writer.put<uint64_t>(frozenVertices.size());
+  for (auto &vertex : frozenVertices) {
+    writer.put<VertexAstType>(vertex.getAstType());
+    writer.put<VertexDirection>(vertex.getDirection());
+    writer.putLocation(vertex.getLocation());
+    writer.putDType(vertex.getDType());
+    writer.putString(vertex.getName());
+    writer.put<uint8_t>(vertex.isParameter());
+    writer.putString(vertex.getParamValue());
+    writer.put<uint8_t>(vertex.isPublic());
+    writer.put<uint8_t>(vertex.isTop());
+    writer.put<uint8_t>(vertex.isDeleted());
+  }
+  // The edges are written as the out and in edges of each vertex, which
+  // preserves their order.
+  writer.put<uint64_t>(csr.numEdges());
+  for (auto reverse : {false, true}) {
+    for (VertexID v = 0; v < frozenVertices.size(); v++) {
+      writer.put<uint32_t>(reverse ? csr.inDegree(v) : csr.outDegree(v));
+      csr.forEachEdge(v, reverse, [&writer](VertexID vertex, bool throughRegister) {
+        writer.put<uint32_t>(CSRGraph::encodeEdge(vertex, throughRegister));
+      });
+    }
+  }
+  writer.put<uint64_t>(aliasMap.size());
+  for (auto &alias : aliasMap) {
+    writer.putString(alias.first);
+    writer.put<uint64_t>(alias.second);
+  }
+}
+
+void Graph::readSnapshot(SnapshotReader &reader) {
+  clear();
+  auto numVertices = reader.getCount();
+  frozenVertices.reserve(numVertices);
+  for (std::size_t i = 0; i < numVertices; i++) {
+    auto astType = reader.get<VertexAstType>();
+    auto direction = reader.get<VertexDirection>();
+    auto location = reader.getLocation();
+    auto dtype = reader.getDType();
+    auto name = reader.getString();
+    auto isParam = reader.get<uint8_t>();
+    auto paramValue = reader.getString();
+    auto isPublic = reader.get<uint8_t>();
+    auto isTop = reader.get<uint8_t>();
+    auto isDeleted = reader.get<uint8_t>();
+    frozenVertices.emplace_back(astType, direction, location, dtype, name,
+                          isParam, paramValue, isPublic, isTop, isDeleted);
+  }
+  auto numEdges = reader.getCount(sizeof(uint32_t));
+  std::vector<uint32_t> offsets[2], edges[2];
+  for (auto reverse : {0, 1}) {
+    offsets[reverse].reserve(numVertices + 1);
+    edges[reverse].reserve(numEdges);
+    for (std::size_t i = 0; i < numVertices; i++) {
+      offsets[reverse].push_back(static_cast<uint32_t>(edges[reverse].size()));
+      auto degree = reader.get<uint32_t>();
+      if (degree > numEdges - edges[reverse].size()) {
+        throw Exception("corrupt netlist snapshot");
+      }
+      for (std::size_t j = 0; j < degree; j++) {
+        edges[reverse].push_back(reader.get<uint32_t>());
+      }
+    }
+    offsets[reverse].push_back(static_cast<uint32_t>(edges[reverse].size()));
+  }
+  csr = CSRGraph(std::move(offsets[0]), std::move(edges[0]),
+                 std::move(offsets[1]), std::move(edges[1]));
+  if (!csr.isValid()) {
+    throw Exception("corrupt netlist snapshot");
+  }
+  frozen = true;
+  auto numAliases = reader.getCount();
+  for (std::size_t i = 0; i < numAliases; i++) {
+    auto name = reader.getString();
+    auto vertex = reader.get<uint64_t>();
+    if (vertex >= numVertices) {
+      throw Exception("corrupt netlist snapshot");
+    }
+    aliasMap[name] = static_cast<VertexID>(vertex);
+  }
+}
+
+void Graph::writeImage(ImageWriter &writer) const {
+  for (VertexID v = 0; v < frozenVertices.size(); v++) {
+    writer.addVertex(frozenVertices[v]);
+    csr.forEachEdge(v, false, [&writer](VertexID target, bool throughRegister) {
+      writer.addOutEdge(target, throughRegister);
+    });
+    csr.forEachEdge(v, true, [&writer](VertexID source, bool throughRegister) {
+      writer.addInEdge(source, throughRegister);
+    });
+  }
+  for (auto &alias : aliasMap) {
+    writer.addAlias(alias.first, alias.second);
+  }
+}
+
+void Graph::setImage(std::shared_ptr<const NetlistImage> netlistImage) {
+  clear();
+  image = netlistImage;
+  csr = image->getGraph().view();
+  frozen = true;
+}
+
+const Vertex &Graph::getVertex(VertexID vertexId) const {
+  if (image) {
+    return image->getVertex(vertexId);
+  }
+  return frozen ? frozenVertices[vertexId] : graph[vertexId];
+}
+
+bool Graph::ownsVertex(const Vertex *vertex) const {
+  if (image) {
+    return image->ownsVertex(vertex);
+  }
+  auto count = numVertices();
+  if (count == 0) {
+    return false;
+  }
+  // Vertex objects are held in an array, so compare with its first and last.
+  const Vertex *first = frozen ? &frozenVertices.front() : &graph[0];
+  const Vertex *last = frozen ? &frozenVertices.back() : &graph[count - 1];
+  std::less<const Vertex*> less;
+  return !less(vertex, first) && !less(last, vertex);
+}
+
+std::size_t Graph::numVertices() const {
+  return frozen ? csr.numVertices() : boost::num_vertices(graph);
+}
+
+std::size_t Graph::numEdges() const {
+  return frozen ? csr.numEdges() : boost::num_edges(graph);
+}
+
+std::string_view Graph::getVertexName(VertexID vertex) const {
+  return image ? image->getName(vertex) : std::string_view(getVertex(vertex).getName());
+}
+
+/// Return the register that a variable is an alias of, or the null vertex.
+VertexID Graph::getAliasRegister(const std::string &name) const {
+  if (image) {
+    return image->getAliasRegister(name);
+  }
+  auto it = aliasMap.find(name);
+  return it != aliasMap.end() ? it->second : nullVertex();
+}
+
+/// The condensation is built on first use for each setting of register
+/// traversal, and shared by all later queries.
+std::shared_ptr<const Condensation> Graph::getCondensation() const {
+  auto traverseRegisters = Options::getInstance().shouldTraverseRegisters();
+  std::lock_guard<std::mutex> lock(condensationMutex);
+  auto &condensation = condensations[traverseRegisters ? 1 : 0];
+  if (!condensation) {
+    condensation = std::make_shared<const Condensation>(csr, traverseRegisters);
+    BOOST_LOG_TRIVIAL(debug) << boost::format("Condensed graph into %d components with %d loops in %d bytes")
+                                  % condensation->getNumComponents()
+                                  % condensation->getLoops().size()
+                                  % condensation->memoryUsage();
+  }
+  return condensation;
+}
+
+std::shared_ptr<const NameIndex> Graph::getNameIndex() const {
+  std::lock_guard<std::mutex> lock(nameIndexMutex);
+  if (!nameIndex) {
+    nameIndex = std::make_shared<const NameIndex>(numVertices(), [this](VertexID vertex) {
+      return getVertexName(vertex);
+    });
+    BOOST_LOG_TRIVIAL(debug) << boost::format("Indexed %d vertex names")
+                                  % nameIndex->numNames();
+  }
+  return nameIndex;
+}
+
+std::size_t Graph::buildReachabilityIndex() {
+  reachabilityIndex = std::make_shared<const ReachabilityIndex>(getCondensation());
+  BOOST_LOG_TRIVIAL(info) << boost::format("Built reachability index of %d components in %d bytes")
+                               % reachabilityIndex->getNumComponents()
+                               % reachabilityIndex->memoryUsage();
+  return reachabilityIndex->memoryUsage();
+}
+
 /// Perform some checks on the netlist and emit warnings if necessary.
 void Graph::checkGraph() const {
-  BGL_FORALL_VERTICES(v, graph, InternalGraph) {
+  for (VertexID v = 0; v < numVertices(); v++) {
+    auto &vertex = getVertex(v);
     // Check there are no Vlvbound nodes.
-    if (graph[v].getName().find("__Vlvbound") != std::string::npos) {
-      BOOST_LOG_TRIVIAL(warning) << boost::format("%s vertex in netlist") % graph[v].toString();
+    if (vertex.getName().find("__Vlvbound") != std::string::npos) {
+      BOOST_LOG_TRIVIAL(warning) << boost::format("%s vertex in netlist") % vertex.toString();
     }
     // Source registers don't have in edges.
-    if (graph[v].isSrcReg()) {
-      if (boost::in_degree(v, graph) > 0) {
-        BOOST_LOG_TRIVIAL(warning) << boost::format("source reg %s has in edges") % graph[v].toString();
+    if (vertex.isSrcReg()) {
+      if (csr.inDegree(v) > 0) {
+        BOOST_LOG_TRIVIAL(warning) << boost::format("source reg %s has in edges") % vertex.toString();
       }
     }
     // Destination registers don't have out edges.
-    if (graph[v].isDstReg()) {
-      if (boost::out_degree(v, graph) > 0) {
-        BOOST_LOG_TRIVIAL(warning) << boost::format("destination reg has out edges") % graph[v].toString();
+    if (vertex.isDstReg()) {
+      if (csr.outDegree(v) > 0) {
+        BOOST_LOG_TRIVIAL(warning) << boost::format("destination reg has out edges") % vertex.toString();
       }
     }
     // NOTE: vertices may be incorrectly marked as reg if a field of a
@@ -209,19 +831,22 @@ void Graph::dumpDotFile(const std::string &outputFilename) const {
   if (!outputFile.is_open()) {
     throw Exception(std::string("unable to open ")+outputFilename);
   }
-  FilteredInternalGraph filteredGraph(graph,
-                                      EdgePredicate(&graph),
-                                      VertexPredicate({}));
   // Loop over all vertices and print properties.
   outputFile << "digraph netlist {\n";
-  BGL_FORALL_VERTICES(v, filteredGraph, FilteredInternalGraph) {
+  for (VertexID v = 0; v < numVertices(); v++) {
     outputFile << v << boost::format(" [label=\"%s %s\"]\n")
-                    % graph[v].getName() % graph[v].getAstTypeStr();
+                    % getVertex(v).getName() % getVertex(v).getAstTypeStr();
   }
-  // Loop over all edges.
-  BGL_FORALL_EDGES(e, filteredGraph, FilteredInternalGraph) {
-    outputFile << boost::format("%d -> %d;\n")
-                    % boost::source(e, graph) % boost::target(e, graph);
+  // Loop over all edges, excluding those through registers unless they are
+  // traversed.
+  auto traverseRegisters = Options::getInstance().shouldTraverseRegisters();
+  for (VertexID v = 0; v < numVertices(); v++) {
+    auto printEdge = [&](VertexID target, bool throughRegister) {
+      if (traverseRegisters || !throughRegister) {
+        outputFile << boost::format("%d -> %d;\n") % v % target;
+      }
+    };
+    csr.forEachEdge(v, false, printEdge);
   }
   outputFile << "}\n";
   outputFile.close();
@@ -229,6 +854,11 @@ void Graph::dumpDotFile(const std::string &outputFilename) const {
   BOOST_LOG_TRIVIAL(info) << boost::format("dot -Tpdf %s -o graph.pdf") % outputFilename;
 }
 
+bool Graph::isGraphType(VertexID vertex, VertexNetlistType graphType) const {
+  return image ? image->isGraphType(vertex, graphType)
+               : getVertex(vertex).isGraphType(graphType);
+}
+
 /// Match a VertexGraphType against a vertex.
 bool Graph::vertexTypeMatch(VertexID vertex, VertexNetlistType graphType) const {
   if (graphType == VertexNetlistType::ANY) {
@@ -237,46 +867,66 @@ bool Graph::vertexTypeMatch(VertexID vertex, VertexNetlistType graphType) const
   if ((graphType == VertexNetlistType::REG ||
        graphType == VertexNetlistType::PORT ||
        graphType == VertexNetlistType::IS_NAMED) &&
-      (graph[vertex].isSrcReg() ||
-       graph[vertex].isSrcRegAlias())) {
+      (isGraphType(vertex, VertexNetlistType::SRC_REG) ||
+       isGraphType(vertex, VertexNetlistType::SRC_REG_ALIAS))) {
     // Source registers and register aliases are duplicates of destination
     // registers and their aliases, so exclude them from queries that can
     // include registers.
     return false;
   }
   // Anything else is handled by isGraphType().
-  return graph[vertex].isGraphType(graphType);
+  return isGraphType(vertex, graphType);
 }
 
 VertexIDVec Graph::getVerticesByType(VertexNetlistType graphType) const {
-  VertexIDVec vertexIDs;
-  BGL_FORALL_VERTICES(v, graph, InternalGraph) {
-    if (vertexTypeMatch(v, graphType)) {
-      vertexIDs.push_back(v);
-    }
-  }
-  return vertexIDs;
+  return parallelScan(VertexID(0), static_cast<VertexID>(numVertices()),
+                      [&](VertexID v) { return vertexTypeMatch(v, graphType); });
 }
 
-/// This implementation will allow the name to contain other regular expression
-/// syntax, and should be improved to match the wildcards directly.
+/// A pattern that starts with literal characters, such as a hierarchical
+/// scope, only needs to be matched against the names with that prefix, which
+/// the name index finds without a scan of the graph.
 VertexIDVec Graph::getVerticesWildcard(const std::string &name,
                                        VertexNetlistType graphType) const {
-  auto nameStr(name);
-  if (Options::getInstance().shouldIgnoreHierarchyMarkers()) {
-    // Ignore '/', '.' and '_' characters.
-    std::replace(nameStr.begin(), nameStr.end(), '/', '?');
-    std::replace(nameStr.begin(), nameStr.end(), '.', '?');
-    std::replace(nameStr.begin(), nameStr.end(), '_', '?');
+  // Ignore '/', '.' and '_' characters if required.
+  WildcardPattern pattern(name, Options::getInstance().shouldIgnoreHierarchyMarkers());
+  auto match = [&](VertexID v) {
+    return vertexTypeMatch(v, graphType) && pattern.match(getVertexName(v));
+  };
+  auto &prefix = pattern.getLiteralPrefix();
+  if (frozen && !prefix.empty()) {
+    VertexIDVec vertexIDs;
+    getNameIndex()->forEachWithPrefix(prefix, [&](VertexID v) {
+      if (match(v)) {
+        vertexIDs.push_back(v);
+      }
+    });
+    std::sort(vertexIDs.begin(), vertexIDs.end());
+    return vertexIDs;
   }
-  VertexIDVec vertexIDs;
-  BGL_FORALL_VERTICES(v, graph, InternalGraph) {
-    if (vertexTypeMatch(v, graphType) &&
-        wildcardMatch(graph[v].getName(), nameStr)) {
-      vertexIDs.push_back(v);
-    }
+  return parallelScan(VertexID(0), static_cast<VertexID>(numVertices()), match);
+}
+
+VertexIDVec Graph::getVerticesUnderScope(const std::string &scope,
+                                         VertexNetlistType graphType) const {
+  if (scope.empty()) {
+    return getVerticesByType(graphType);
+  }
+  auto prefix = scope + ".";
+  if (frozen) {
+    VertexIDVec vertexIDs;
+    getNameIndex()->forEachWithPrefix(prefix, [&](VertexID v) {
+      if (vertexTypeMatch(v, graphType)) {
+        vertexIDs.push_back(v);
+      }
+    });
+    std::sort(vertexIDs.begin(), vertexIDs.end());
+    return vertexIDs;
   }
-  return vertexIDs;
+  return parallelScan(VertexID(0), static_cast<VertexID>(numVertices()), [&](VertexID v) {
+    return getVertexName(v).substr(0, prefix.size()) == prefix &&
+           vertexTypeMatch(v, graphType);
+  });
 }
 
 VertexIDVec Graph::getVerticesRegex(const std::string &name,
@@ -288,28 +938,53 @@ VertexIDVec Graph::getVerticesRegex(const std::string &name,
     std::replace(nameStr.begin(), nameStr.end(), '_', '.');
   }
   // Catch any errors in the regex string.
+  auto useBoost = Options::getInstance().isRegexEngineBoost();
   std::regex nameRegex;
+  boost::regex nameBoostRegex;
   try {
-    nameRegex.assign(nameStr);
+    if (useBoost) {
+      nameBoostRegex.assign(nameStr);
+    } else {
+      nameRegex.assign(nameStr);
+    }
   } catch(std::regex_error const &e) {
     throw Exception(std::string("malformed regular expression: ")+e.what());
+  } catch(boost::regex_error const &e) {
+    throw Exception(std::string("malformed regular expression: ")+e.what());
   }
-  // Search the vertices.
-  VertexIDVec vertexIDs;
-  BGL_FORALL_VERTICES(v, graph, InternalGraph) {
-    if (vertexTypeMatch(v, graphType) &&
-        std::regex_search(graph[v].getName(), nameRegex)) {
-      vertexIDs.push_back(v);
+  // Names without the literal parts of the regex cannot match, so they are
+  // rejected with a substring search before the regex is run.
+  auto literals = getRequiredRegexLiterals(nameStr);
+  // Search the vertices. The compiled regexes are only read by the search, so
+  // they are shared by the threads of a parallel scan.
+  auto match = [&](VertexID v) {
+    auto name = getVertexName(v);
+    if (!vertexTypeMatch(v, graphType) ||
+        std::any_of(literals.begin(), literals.end(), [name](const std::string &literal) {
+          return name.find(literal) == std::string_view::npos;
+        })) {
+      return false;
     }
-  }
-  return vertexIDs;
+    return useBoost ? boost::regex_search(name.begin(), name.end(), nameBoostRegex)
+                    : std::regex_search(name.begin(), name.end(), nameRegex);
+  };
+  return parallelScan(VertexID(0), static_cast<VertexID>(numVertices()), match);
 }
 
 VertexID Graph::getVertexExact(const std::string &name,
                                VertexNetlistType graphType) const {
-  BGL_FORALL_VERTICES(v, graph, InternalGraph) {
+  if (frozen) {
+    auto vertices = getNameIndex()->find(name);
+    for (auto it = vertices.first; it != vertices.second; ++it) {
+      if (vertexTypeMatch(*it, graphType)) {
+        return *it;
+      }
+    }
+    return nullVertex();
+  }
+  for (VertexID v = 0; v < numVertices(); v++) {
     if (vertexTypeMatch(v, graphType) &&
-        graph[v].getName() == name) {
+        getVertexName(v) == name) {
       return v;
     }
   }
@@ -336,115 +1011,158 @@ VertexIDVec Graph::getVertices(const std::string &pattern,
 
 /// Given the tree structure from a DFS, traverse the tree from leaf to root to
 /// return a path.
-VertexIDVec Graph::determinePath(ParentMap &parentMap,
-                                 VertexIDVec path,
+VertexIDVec Graph::determinePath(const QueryWorkspace &workspace,
                                  VertexID startVertex,
                                  VertexID finishVertex) const {
-  path.push_back(finishVertex);
-  if (finishVertex == startVertex) {
-    return path;
-  }
-  if (parentMap[finishVertex].empty()) {
+  if (!workspace.isVisited(0, finishVertex)) {
     return VertexIDVec();
   }
-  assert(parentMap[finishVertex].size() == 1);
-  auto nextVertex = parentMap[finishVertex].front();
-  assert(std::find(std::begin(path),
-                   std::end(path),
-                   nextVertex) == std::end(path));
-  return determinePath(parentMap, path, startVertex, nextVertex);
-}
-
-/// Determine all paths between a start and an end point.
-/// This performs a DFS starting at the end point. It is not feasible for large
-/// graphs since the number of simple paths grows exponentially.
-void Graph::determineAllPaths(ParentMap &parentMap,
-                              std::vector<VertexIDVec> &result,
-                              VertexIDVec path,
-                              VertexID startVertex,
-                              VertexID finishVertex) const {
-  path.push_back(finishVertex);
-  if (finishVertex == startVertex) {
-    BOOST_LOG_TRIVIAL(debug) << "Found path";
-    result.push_back(path);
-    return;
-  }
-  BOOST_LOG_TRIVIAL(debug) << boost::format("length %d vertex %s")
-                                % path.size() % graph[finishVertex].toString();
-  // Dump path.
-  if (Options::getInstance().isDebugMode()) {
-    for (auto v : path) {
-      if (!graph[v].isLogic()) {
-        BOOST_LOG_TRIVIAL(debug) << " " << graph[v].getName();
-      }
-    }
+  VertexIDVec path;
+  for (auto vertex = finishVertex; vertex != startVertex;
+       vertex = workspace.getParent(0, vertex)) {
+    path.push_back(vertex);
   }
-  BOOST_LOG_TRIVIAL(debug) << (parentMap[finishVertex].empty() ? "DEAD END" : "");
-  for (auto vertex : parentMap[finishVertex]) {
-    if (std::find(std::begin(path), std::end(path), vertex) == std::end(path)) {
-      determineAllPaths(parentMap, result, path, startVertex, vertex);
-    } else {
+  path.push_back(startVertex);
+  return path;
+}
+
+/// Search for all paths between a start and a finish vertex, recording the
+/// parents of each vertex from every edge to it, and start a walk of the
+/// paths back from the finish vertex. The search only visits vertices that
+/// can reach the finish, so that paths are not extended into parts of the
+/// graph, such as loops downstream of the finish, that cannot lead to it.
+void Graph::searchAllPaths(QueryWorkspace &workspace,
+                           const Condensation &condensation,
+                           VertexID startVertex,
+                           VertexID finishVertex,
+                           const VertexIDVec &avoidPointIDs) const {
+  auto &components = condensation.getComponents();
+  csr.depthFirstSearch(workspace, startVertex, true, false, &avoidPointIDs,
+                       components.data(), components[finishVertex]);
+  startPathWalk(workspace, startVertex, finishVertex);
+}
+
+/// Start a walk of the paths recorded by searchAllPaths(), which can be
+/// repeated once a previous walk has finished.
+void Graph::startPathWalk(QueryWorkspace &workspace,
+                          VertexID startVertex,
+                          VertexID finishVertex) const {
+  if (workspace.isVisited(0, finishVertex)) {
+    workspace.path.push_back(finishVertex);
+    workspace.setOnPath(finishVertex, true);
+    workspace.pathEntries.push_back(finishVertex == startVertex
+                                      ? QueryWorkspace::FOUND
+                                      : workspace.getParentHead(finishVertex));
+  }
+}
+
+/// Advance a walk of the paths recorded by searchAllPaths() to the next path,
+/// which is left in the workspace from the finish vertex back to the start.
+/// The walk is a DFS back from the finish along the parent lists, with the
+/// path held in a single buffer with a stack of the next parent list entry
+/// to follow from each vertex on it. It is not feasible for large graphs
+/// since the number of simple paths grows exponentially, but each step only
+/// uses memory in proportion to the length of the path.
+///
+/// \returns False when there are no more paths.
+bool Graph::nextPath(QueryWorkspace &workspace, VertexID startVertex) const {
+  auto &path = workspace.path;
+  auto &nextEntries = workspace.pathEntries;
+  while (!path.empty()) {
+    auto entry = nextEntries.back();
+    if (entry == QueryWorkspace::FOUND) {
+      BOOST_LOG_TRIVIAL(debug) << "Found path";
+      nextEntries.back() = QueryWorkspace::NONE;
+      return true;
+    }
+    if (entry == QueryWorkspace::NONE) {
+      workspace.setOnPath(path.back(), false);
+      path.pop_back();
+      nextEntries.pop_back();
+      continue;
+    }
+    auto &parentEntry = workspace.parentEntries[entry];
+    nextEntries.back() = parentEntry.next;
+    if (workspace.isOnPath(parentEntry.parent)) {
       BOOST_LOG_TRIVIAL(debug) << "Cycle detected";
+      continue;
     }
+    auto vertex = static_cast<VertexID>(parentEntry.parent);
+    path.push_back(vertex);
+    workspace.setOnPath(vertex, true);
+    nextEntries.push_back(vertex == startVertex ? QueryWorkspace::FOUND
+                                                : workspace.getParentHead(vertex));
   }
+  return false;
 }
 
-/// Report all paths fanning out from a net/register/port.
+/// Return the vertices of a type that were visited by a search, in
+/// increasing order, which takes time proportional to the number of vertices
+/// visited rather than the size of the graph.
+VertexIDVec Graph::getVisitedPoints(const QueryWorkspace &workspace,
+                                    VertexNetlistType graphType) const {
+  VertexIDVec points;
+  for (auto vertex : workspace.visited) {
+    if (isGraphType(vertex, graphType)) {
+      points.push_back(vertex);
+    }
+  }
+  std::sort(points.begin(), points.end());
+  return points;
+}
+
+/// Report all paths fanning out from a net/register/port. Paths are only
+/// determined for the end points reached by the search.
 std::vector<VertexIDVec>
 Graph::getAllFanOut(VertexID startVertex) const {
-  FilteredInternalGraph filteredGraph(graph,
-                                      EdgePredicate(&graph),
-                                      VertexPredicate());
-  BOOST_LOG_TRIVIAL(debug) << "Performing DFS from " << graph[startVertex].getName();
-  ParentMap parentMap;
-  boost::depth_first_search(filteredGraph,
-      boost::visitor(DfsVisitor(parentMap, false))
-        .root_vertex(startVertex));
-  // Check for a path between startPoint and each register.
+  BOOST_LOG_TRIVIAL(debug) << "Performing DFS from " << getVertexName(startVertex);
+  auto &workspace = QueryWorkspace::get();
+  csr.depthFirstSearch(workspace, startVertex, false, false, nullptr);
   std::vector<VertexIDVec> paths;
-  BGL_FORALL_VERTICES(v, graph, InternalGraph) {
-    if (graph[v].isEndPoint()) {
-      auto path = determinePath(parentMap,
-                                VertexIDVec(),
-                                startVertex,
-                                static_cast<VertexID>(v));
-      if (!path.empty()) {
-        std::reverse(std::begin(path), std::end(path));
-        paths.push_back(path);
-      }
-    }
+  for (auto v : getVisitedPoints(workspace, VertexNetlistType::END_POINT)) {
+    auto path = determinePath(workspace, startVertex, v);
+    std::reverse(std::begin(path), std::end(path));
+    paths.push_back(path);
   }
   return paths;
 }
 
-/// Report all paths fanning into a net/register/port.
+/// Report all paths fanning into a net/register/port. Paths are only
+/// determined for the start points reached by the search.
 std::vector<VertexIDVec>
 Graph::getAllFanIn(VertexID finishVertex) const {
-  FilteredInternalGraph filteredGraph(graph,
-                                      EdgePredicate(&graph),
-                                      VertexPredicate());
-  auto reverseGraph = boost::make_reverse_graph(filteredGraph);
-  BOOST_LOG_TRIVIAL(debug) << "Performing DFS in reverse graph from " << graph[finishVertex].getName();
-  ParentMap parentMap;
-  boost::depth_first_search(reverseGraph,
-      boost::visitor(DfsVisitor(parentMap, false))
-        .root_vertex(finishVertex));
-  // Check for a path between endPoint and each register.
+  BOOST_LOG_TRIVIAL(debug) << "Performing DFS in reverse graph from " << getVertexName(finishVertex);
+  auto &workspace = QueryWorkspace::get();
+  csr.depthFirstSearch(workspace, finishVertex, false, true, nullptr);
   std::vector<VertexIDVec> paths;
-  BGL_FORALL_VERTICES(v, graph, InternalGraph) {
-    if (graph[v].isStartPoint()) {
-      auto path = determinePath(parentMap,
-                                VertexIDVec(),
-                                finishVertex,
-                                static_cast<VertexID>(v));
-      if (!path.empty()) {
-        paths.push_back(path);
-      }
-    }
+  for (auto v : getVisitedPoints(workspace, VertexNetlistType::START_POINT)) {
+    paths.push_back(determinePath(workspace, finishVertex, v));
   }
   return paths;
 }
 
+/// Count the end points reachable from a net/register/port, without
+/// determining the paths to them.
+size_t Graph::getfanOutDegree(VertexID startVertex) const {
+  auto &workspace = QueryWorkspace::get();
+  csr.findReachable(workspace, startVertex, false);
+  auto &reachable = workspace.frontiers[0];
+  return std::count_if(reachable.begin(), reachable.end(), [this](VertexID v) {
+    return isGraphType(v, VertexNetlistType::END_POINT);
+  });
+}
+
+/// Count the start points that reach a net/register/port, without
+/// determining the paths from them.
+size_t Graph::getFanInDegree(VertexID finishVertex) const {
+  auto &workspace = QueryWorkspace::get();
+  csr.findReachable(workspace, finishVertex, true);
+  auto &reachable = workspace.frontiers[0];
+  return std::count_if(reachable.begin(), reachable.end(), [this](VertexID v) {
+    return isGraphType(v, VertexNetlistType::START_POINT);
+  });
+}
+
 /// Given a vector of vectors of paths (the set of all paths between each
 /// through point), return a vector of paths that is the cartesian product of
 /// the paths in each stage. Based on code in:
@@ -472,11 +1190,10 @@ pathProduct(const std::vector<std::vector<VertexIDVec>>& intPaths) {
 
 /// Return true if exactly two waypoints correspond to aliases of the same variable.
 bool Graph::isAliasPath(const VertexIDVec &waypointIDs) const {
-  if (waypointIDs.size() == 2 &&
-      aliasMap.count(graph[waypointIDs[0]].getName()) &&
-      aliasMap.count(graph[waypointIDs[1]].getName())) {
-    return aliasMap.at(graph[waypointIDs[0]].getName()) ==
-               aliasMap.at(graph[waypointIDs[1]].getName());
+  if (waypointIDs.size() == 2) {
+    auto reg = getAliasRegister(std::string(getVertexName(waypointIDs[0])));
+    return reg != nullVertex() &&
+           reg == getAliasRegister(std::string(getVertexName(waypointIDs[1])));
   }
   return false;
 }
@@ -489,30 +1206,24 @@ Graph::getAllPointToPoint(const VertexIDVec &waypointIDs,
   // Special case for paths between aliases of the same variable.
   if (isAliasPath(waypointIDs)) {
     BOOST_LOG_TRIVIAL(debug) << boost::format("%s is alias of %s")
-                                  % graph[waypointIDs[0]].getName()
-                                  % graph[waypointIDs[1]].getName();
+                                  % getVertexName(waypointIDs[0])
+                                  % getVertexName(waypointIDs[1]);
     return {{waypointIDs[0], waypointIDs[1]}};
   }
-  FilteredInternalGraph filteredGraph(graph,
-                                      EdgePredicate(&graph),
-                                      VertexPredicate(&avoidPointIDs));
   std::vector<std::vector<VertexIDVec> > intPaths;
+  auto &workspace = QueryWorkspace::get();
+  auto condensation = getCondensation();
   // Elaborate all paths between each adjacent waypoint.
   for (std::size_t i = 0; i < waypointIDs.size()-1; ++i) {
     auto beginVertex = waypointIDs[i];
     auto endVertex = waypointIDs[i+1];
-    BOOST_LOG_TRIVIAL(debug) << "Performing DFS from " << graph[beginVertex].getName();
-    ParentMap parentMap;
-    boost::depth_first_search(filteredGraph,
-        boost::visitor(DfsVisitor(parentMap, true))
-          .root_vertex(beginVertex));
-    BOOST_LOG_TRIVIAL(debug) << "Determining all paths to " << graph[endVertex].getName();
+    BOOST_LOG_TRIVIAL(debug) << "Performing DFS from " << getVertexName(beginVertex);
+    searchAllPaths(workspace, *condensation, beginVertex, endVertex, avoidPointIDs);
+    BOOST_LOG_TRIVIAL(debug) << "Determining all paths to " << getVertexName(endVertex);
     std::vector<VertexIDVec> paths;
-    determineAllPaths(parentMap,
-                      paths,
-                      VertexIDVec(),
-                      beginVertex,
-                      endVertex);
+    while (nextPath(workspace, beginVertex)) {
+      paths.push_back(workspace.path);
+    }
     if (paths.empty()) {
       // No paths exist.
       return {};
@@ -527,41 +1238,178 @@ Graph::getAllPointToPoint(const VertexIDVec &waypointIDs,
   return paths;
 }
 
+/// Return true if a path exists between a set of named points.
+bool Graph::pathExists(const VertexIDVec &waypointIDs,
+                       const VertexIDVec &avoidPointIDs) const {
+  if (isAliasPath(waypointIDs)) {
+    return true;
+  }
+  // Use the reachability index if it applies to the query.
+  if (reachabilityIndex && avoidPointIDs.empty() &&
+      reachabilityIndex->isTraverseRegisters() ==
+        Options::getInstance().shouldTraverseRegisters()) {
+    for (std::size_t i = 0; i < waypointIDs.size()-1; ++i) {
+      if (!reachabilityIndex->reaches(waypointIDs[i], waypointIDs[i+1])) {
+        return false;
+      }
+    }
+    return true;
+  }
+  auto condensation = getCondensation();
+  for (std::size_t i = 0; i < waypointIDs.size()-1; ++i) {
+    if (!csr.findPath(QueryWorkspace::get(), waypointIDs[i], waypointIDs[i+1],
+                      &avoidPointIDs, nullptr, condensation->getComponents().data())) {
+      return false;
+    }
+  }
+  return true;
+}
+
 /// Report a single path between a set of named points.
 VertexIDVec Graph::getAnyPointToPoint(const VertexIDVec &waypointIDs,
                                       const VertexIDVec &avoidPointIDs) const {
   // Special case for paths between aliases of the same variable.
   if (isAliasPath(waypointIDs)) {
     BOOST_LOG_TRIVIAL(debug) << boost::format("%s is alias of %s")
-                                  % graph[waypointIDs[0]].getName()
-                                  % graph[waypointIDs[1]].getName();
+                                  % getVertexName(waypointIDs[0])
+                                  % getVertexName(waypointIDs[1]);
     return {waypointIDs[0], waypointIDs[1]};
   }
-  FilteredInternalGraph filteredGraph(graph,
-                                      EdgePredicate(&graph),
-                                      VertexPredicate(&avoidPointIDs));
   std::vector<VertexID> path;
+  VertexIDVec subPath;
+  auto &workspace = QueryWorkspace::get();
+  auto condensation = getCondensation();
   // Construct the path between each adjacent waypoint.
   for (std::size_t i = 0; i < waypointIDs.size()-1; ++i) {
     auto startVertex = waypointIDs[i];
     auto finishVertex = waypointIDs[i+1];
-    BOOST_LOG_TRIVIAL(debug) << "Performing DFS from " << graph[startVertex].getName();
-    ParentMap parentMap;
-    boost::depth_first_search(filteredGraph,
-        boost::visitor(DfsVisitor(parentMap, false))
-          .root_vertex(startVertex));
-    BOOST_LOG_TRIVIAL(debug) << "Determining a path to " << graph[finishVertex].getName();
-    auto subPath = determinePath(parentMap,
-                                 VertexIDVec(),
-                                 startVertex,
-                                 finishVertex);
-    if (subPath.empty()) {
+    BOOST_LOG_TRIVIAL(debug) << "Searching for a path from " << getVertexName(startVertex)
+                             << " to " << getVertexName(finishVertex);
+    if (!csr.findPath(workspace, startVertex, finishVertex, &avoidPointIDs, &subPath,
+                      condensation->getComponents().data())) {
       // No path exists.
       return VertexIDVec();
     }
-    std::reverse(std::begin(subPath), std::end(subPath));
     path.insert(std::end(path), std::begin(subPath), std::end(subPath)-1);
   }
   path.push_back(waypointIDs.back());
   return path;
 }
+
+/// Count the paths between each adjacent waypoint, and multiply the counts.
+uint64_t Graph::countPaths(const VertexIDVec &waypointIDs,
+                           const VertexIDVec &avoidPointIDs) const {
+  if (isAliasPath(waypointIDs)) {
+    return 1;
+  }
+  auto condensation = getCondensation();
+  auto isLoop = [&](uint32_t component) { return isLogicLoop(*condensation, component); };
+  auto &workspace = QueryWorkspace::get();
+  uint64_t count = 1;
+  for (std::size_t i = 0; i < waypointIDs.size()-1; ++i) {
+    auto startVertex = waypointIDs[i];
+    auto finishVertex = waypointIDs[i+1];
+    csr.countPaths(workspace, startVertex, finishVertex, false, &avoidPointIDs,
+                   *condensation, isLoop);
+    if (!workspace.isVisited(0, finishVertex)) {
+      return 0;
+    }
+    auto segmentCount = workspace.counts[finishVertex];
+    count = count > UINT64_MAX / segmentCount ? UINT64_MAX : count * segmentCount;
+  }
+  return count;
+}
+
+/// Count the paths fanning out from a net/register/port to each end point.
+std::vector<std::pair<VertexID, uint64_t>>
+Graph::countFanOutPaths(VertexID startVertex) const {
+  auto condensation = getCondensation();
+  auto &workspace = QueryWorkspace::get();
+  csr.countPaths(workspace, startVertex, nullVertex(), false, nullptr, *condensation,
+                 [&](uint32_t component) { return isLogicLoop(*condensation, component); });
+  std::vector<std::pair<VertexID, uint64_t>> counts;
+  for (auto v : getVisitedPoints(workspace, VertexNetlistType::END_POINT)) {
+    counts.emplace_back(v, workspace.counts[v]);
+  }
+  return counts;
+}
+
+/// Count the paths fanning in to a net/register/port from each start point.
+std::vector<std::pair<VertexID, uint64_t>>
+Graph::countFanInPaths(VertexID finishVertex) const {
+  auto condensation = getCondensation();
+  auto &workspace = QueryWorkspace::get();
+  csr.countPaths(workspace, finishVertex, nullVertex(), true, nullptr, *condensation,
+                 [&](uint32_t component) { return isLogicLoop(*condensation, component); });
+  std::vector<std::pair<VertexID, uint64_t>> counts;
+  for (auto v : getVisitedPoints(workspace, VertexNetlistType::START_POINT)) {
+    counts.emplace_back(v, workspace.counts[v]);
+  }
+  return counts;
+}
+
+ReachabilityMatrix Graph::getReachabilityMatrix(const VertexIDVec &startVertices,
+                                                const VertexIDVec &endVertices) const {
+  auto condensation = getCondensation();
+  ReachabilityMatrix matrix;
+  for (auto vertex : startVertices) {
+    matrix.startPoints.push_back(getVertexPtr(vertex));
+  }
+  for (auto vertex : endVertices) {
+    matrix.endPoints.push_back(getVertexPtr(vertex));
+  }
+  std::vector<ReachabilityMatrix::Entry> entries;
+  std::vector<uint64_t> bits(condensation->getNumComponents());
+  for (std::size_t first = 0; first < startVertices.size(); first += 64) {
+    std::fill(bits.begin(), bits.end(), 0);
+    auto last = std::min(first + 64, startVertices.size());
+    uint32_t highest = 0;
+    for (auto i = first; i < last; i++) {
+      auto component = condensation->getComponent(startVertices[i]);
+      bits[component] |= uint64_t(1) << (i - first);
+      highest = std::max(highest, component);
+    }
+    // Components are numbered in reverse topological order, so every
+    // component has its bits before they are passed on.
+    for (auto component = highest + 1; component-- > 0;) {
+      if (bits[component] != 0) {
+        condensation->forEachAdjacent(component, false, [&](uint32_t next) {
+          bits[next] |= bits[component];
+        });
+      }
+    }
+    for (std::size_t i = 0; i < endVertices.size(); i++) {
+      auto word = bits[condensation->getComponent(endVertices[i])];
+      if (word != 0) {
+        entries.push_back({static_cast<uint32_t>(i),
+                           static_cast<uint32_t>(first / 64), word});
+      }
+    }
+  }
+  matrix.setColumns(entries);
+  return matrix;
+}
+
+/// The edges added between a variable and its aliases, through an
+/// ASSIGN_ALIAS vertex, and between a port and its copy in the enclosing
+/// scope, form cycles that are not loops in the logic, so a component is only
+/// a loop if it contains other logic.
+bool Graph::isLogicLoop(const Condensation &condensation, uint32_t component) const {
+  auto members = condensation.getMembers(component);
+  return std::any_of(members.begin(), members.end(), [this](VertexID vertex) {
+    auto &member = getVertex(vertex);
+    return member.isLogic() && member.getAstType() != VertexAstType::ASSIGN_ALIAS;
+  });
+}
+
+/// Report the strongly-connected components that form loops in the logic.
+std::vector<VertexIDVec> Graph::getLoops() const {
+  auto condensation = getCondensation();
+  std::vector<VertexIDVec> loops;
+  for (auto component : condensation->getLoops()) {
+    if (isLogicLoop(*condensation, component)) {
+      loops.push_back(condensation->getMembers(component));
+    }
+  }
+  return loops;
+}
@@ -0,0 +1,69 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "netlist_paths/Exception.hpp"
+#include "netlist_paths/MappedFile.hpp"
+
+using namespace netlist_paths;
+
+MappedFile::MappedFile(const std::string &filename, bool shared) :
+    data(nullptr), size(0), mappedSize(0) {
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd == -1) {
+    throw Exception(std::string("could not open file ")+filename);
+  }
+  struct stat fileStat;
+  if (::fstat(fd, &fileStat) == -1) {
+    ::close(fd);
+    throw Exception(std::string("could not stat file ")+filename);
+  }
+  size = static_cast<std::size_t>(fileStat.st_size);
+  if (shared) {
+    // Map the file directly, so that its pages are shared with other
+    // processes through the page cache. An empty file cannot be mapped.
+    if (size > 0) {
+      void *region = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+      if (region == MAP_FAILED) {
+        ::close(fd);
+        throw Exception(std::string("could not map file ")+filename);
+      }
+      data = static_cast<char*>(region);
+      mappedSize = size;
+    }
+    ::close(fd);
+    return;
+  }
+  // Reserve an anonymous region large enough for the file contents plus a
+  // terminator. When the file size is a multiple of the page size, the
+  // terminator falls in a page beyond the end of the file, which cannot be
+  // backed by the file mapping itself.
+  auto pageSize = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+  mappedSize = ((size + 1 + pageSize - 1) / pageSize) * pageSize;
+  void *region = ::mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (region == MAP_FAILED) {
+    ::close(fd);
+    throw Exception(std::string("could not map file ")+filename);
+  }
+  // Overlay a private (copy-on-write) mapping of the file onto the start of
+  // the region.
+  if (size > 0 &&
+      ::mmap(region, size, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+    ::munmap(region, mappedSize);
+    ::close(fd);
+    throw Exception(std::string("could not map file ")+filename);
+  }
+  ::close(fd);
+  // The contents are parsed front to back, so request aggressive read ahead.
+  ::madvise(region, mappedSize, MADV_SEQUENTIAL);
+  data = static_cast<char*>(region);
+  data[size] = '\0';
+}
+
+MappedFile::~MappedFile() {
+  if (data) {
+    ::munmap(data, mappedSize);
+  }
+}
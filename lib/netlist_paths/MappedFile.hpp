@@ -0,0 +1,44 @@
+#ifndef NETLIST_PATHS_MAPPED_FILE_HPP
+#define NETLIST_PATHS_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+
+namespace netlist_paths {
+
+/// A memory mapping of a file's contents. By default, the mapping is private
+/// and copy-on-write, and is followed by a null terminator. The mapped bytes
+/// can then be modified without affecting the underlying file, which allows
+/// them to be parsed in situ. A shared mapping is read only and has no
+/// terminator, and its pages are shared through the page cache with every
+/// other process that maps the same file.
+class MappedFile {
+  char *data;
+  std::size_t size;
+  std::size_t mappedSize;
+
+public:
+  MappedFile() = delete;
+
+  /// Map a file into memory.
+  ///
+  /// \param filename The path of the file to map.
+  /// \param shared   Map the file read only and shared with other processes.
+  MappedFile(const std::string &filename, bool shared=false);
+
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile &operator=(const MappedFile&) = delete;
+
+  /// Return a pointer to the contents of the file, which are null terminated
+  /// unless the mapping is shared.
+  char *getData() const { return data; }
+
+  /// Return the size of the file in bytes (excluding any terminator).
+  std::size_t getSize() const { return size; }
+};
+
+} // End netlist_paths namespace.
+
+#endif // NETLIST_PATHS_MAPPED_FILE_HPP
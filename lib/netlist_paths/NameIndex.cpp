@@ -0,0 +1,56 @@
+#include <algorithm>
+#include "netlist_paths/NameIndex.hpp"
+
+using namespace netlist_paths;
+
+/// The vertices are grouped by name with a counting sort, so each group keeps
+/// the order of its vertices.
+NameIndex::NameIndex(std::size_t numVertices,
+                     const std::function<std::string_view(VertexID)> &getName) {
+  std::vector<uint32_t> vertexGroups(numVertices, UINT32_MAX);
+  groups.reserve(numVertices);
+  for (VertexID vertex = 0; vertex < numVertices; vertex++) {
+    auto name = getName(vertex);
+    if (name.empty()) {
+      continue;
+    }
+    auto result = groups.emplace(name, static_cast<uint32_t>(groups.size()));
+    if (result.second) {
+      groupNames.push_back(name);
+    }
+    vertexGroups[vertex] = result.first->second;
+  }
+  sortedGroups.resize(groups.size());
+  for (std::size_t group = 0; group < groups.size(); group++) {
+    sortedGroups[group] = static_cast<uint32_t>(group);
+  }
+  std::sort(sortedGroups.begin(), sortedGroups.end(), [this](uint32_t a, uint32_t b) {
+    return groupNames[a] < groupNames[b];
+  });
+  offsets.assign(groups.size() + 1, 0);
+  for (auto group : vertexGroups) {
+    if (group != UINT32_MAX) {
+      offsets[group + 1]++;
+    }
+  }
+  for (std::size_t group = 0; group < groups.size(); group++) {
+    offsets[group + 1] += offsets[group];
+  }
+  vertices.resize(offsets.back());
+  std::vector<uint32_t> next(offsets.begin(), offsets.end() - 1);
+  for (VertexID vertex = 0; vertex < numVertices; vertex++) {
+    if (vertexGroups[vertex] != UINT32_MAX) {
+      vertices[next[vertexGroups[vertex]]++] = vertex;
+    }
+  }
+}
+
+std::pair<const VertexID*, const VertexID*>
+NameIndex::find(std::string_view name) const {
+  auto it = groups.find(name);
+  if (it == groups.end()) {
+    return {nullptr, nullptr};
+  }
+  return {vertices.data() + offsets[it->second],
+          vertices.data() + offsets[it->second + 1]};
+}
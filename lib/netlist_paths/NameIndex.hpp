@@ -0,0 +1,72 @@
+#ifndef NETLIST_PATHS_NAME_INDEX_HPP
+#define NETLIST_PATHS_NAME_INDEX_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "netlist_paths/Graph.hpp"
+
+namespace netlist_paths {
+
+/// An index of the vertices of a frozen graph by name. A hash of the names
+/// makes an exact name lookup take constant time rather than a scan of the
+/// graph. Several vertices can share a name, such as the source and
+/// destination parts of a register, so each name maps to a list of vertices,
+/// in increasing order.
+///
+/// The distinct names are also kept in sorted order, which flattens the trie
+/// of the dot-separated components of hierarchical names: the names in any
+/// scope of the hierarchy, or with any other prefix, form a contiguous range
+/// that is found with a binary search.
+///
+/// The names are not copied, so the index refers to the storage of the names
+/// in the graph, which must not change while the index is in use.
+class NameIndex {
+  std::unordered_map<std::string_view, uint32_t> groups;
+  std::vector<std::string_view> groupNames;
+  std::vector<uint32_t> sortedGroups;
+  std::vector<uint32_t> offsets;
+  std::vector<VertexID> vertices;
+
+public:
+  /// Build an index of the named vertices of a graph.
+  ///
+  /// \param numVertices The number of vertices in the graph.
+  /// \param getName     A function returning the name of a vertex, which is
+  ///                    empty if the vertex has no name.
+  NameIndex(std::size_t numVertices,
+            const std::function<std::string_view(VertexID)> &getName);
+
+  /// Return the range of vertices with a name, in increasing order, which is
+  /// empty if no vertex has the name.
+  std::pair<const VertexID*, const VertexID*> find(std::string_view name) const;
+
+  /// Call a function with each vertex whose name starts with a prefix, in
+  /// order of name.
+  template<typename Function>
+  void forEachWithPrefix(std::string_view prefix, Function function) const {
+    auto first = std::lower_bound(sortedGroups.begin(), sortedGroups.end(), prefix,
+                                  [this](uint32_t group, std::string_view value) {
+                                    return groupNames[group] < value;
+                                  });
+    for (auto it = first; it != sortedGroups.end(); ++it) {
+      if (groupNames[*it].substr(0, prefix.size()) != prefix) {
+        break;
+      }
+      for (auto i = offsets[*it]; i < offsets[*it + 1]; i++) {
+        function(vertices[i]);
+      }
+    }
+  }
+
+  /// Return the number of distinct names in the index.
+  std::size_t numNames() const { return groups.size(); }
+};
+
+} // End netlist_paths namespace.
+
+#endif // NETLIST_PATHS_NAME_INDEX_HPP
@@ -1,7 +1,9 @@
 #include <regex>
 #include <boost/format.hpp>
 #include "netlist_paths/Netlist.hpp"
+#include "netlist_paths/NetlistImage.hpp"
 #include "netlist_paths/ReadVerilatorXML.hpp"
+#include "netlist_paths/Snapshot.hpp"
 
 using namespace netlist_paths;
 
@@ -11,6 +13,35 @@ Netlist::Netlist(const std::string &filename) {
   graph.markAliasRegisters();
   graph.splitRegVertices();
   graph.updateVarAliases();
+  graph.freeze();
+}
+
+void Netlist::save(const std::string &filename) const {
+  if (graph.isImage()) {
+    throw Exception("cannot save a netlist opened from an image");
+  }
+  writeSnapshot(filename, graph, files, dtypes);
+}
+
+std::unique_ptr<Netlist> Netlist::load(const std::string &filename) {
+  Options::getInstance(); // Create singleton object.
+  std::unique_ptr<Netlist> netlist(new Netlist());
+  readSnapshot(filename, netlist->graph, netlist->files, netlist->dtypes);
+  return netlist;
+}
+
+void Netlist::saveImage(const std::string &filename) const {
+  if (graph.isImage()) {
+    throw Exception("cannot save a netlist opened from an image");
+  }
+  writeImage(filename, graph, files, dtypes);
+}
+
+std::unique_ptr<Netlist> Netlist::openImage(const std::string &filename) {
+  Options::getInstance(); // Create singleton object.
+  std::unique_ptr<Netlist> netlist(new Netlist());
+  readImage(filename, netlist->graph, netlist->files, netlist->dtypes);
+  return netlist;
 }
 
 std::vector<Vertex*>
@@ -255,7 +286,7 @@ bool Netlist::regExists(const std::string &name) const {
 bool Netlist::pathExists(Waypoints waypoints) const {
   auto waypointIDs = readWaypoints(waypoints);
   auto avoidPointIDs = readAvoidPoints(waypoints);
-  return !graph.getAnyPointToPoint(waypointIDs, avoidPointIDs).empty();
+  return graph.pathExists(waypointIDs, avoidPointIDs);
 }
 
 std::vector<Vertex*> Netlist::getAnyPath(Waypoints waypoints) const {
@@ -272,6 +303,12 @@ std::vector<std::vector<Vertex*> > Netlist::getAllPaths(Waypoints waypoints) con
                                                           avoidPointIDs));
 }
 
+std::unique_ptr<PathEnumerator> Netlist::getPathEnumerator(Waypoints waypoints) const {
+  auto waypointIDs = readWaypoints(waypoints);
+  auto avoidPointIDs = readAvoidPoints(waypoints);
+  return std::make_unique<PathEnumerator>(graph, waypointIDs, avoidPointIDs);
+}
+
 std::vector<std::vector<Vertex*> > Netlist::getAllFanOut(const std::string startName) const {
   auto vertex = getStartVertex(startName, Options::getInstance().isMatchAnyVertex());
   if (vertex == graph.nullVertex()) {
@@ -288,6 +325,60 @@ std::vector<std::vector<Vertex*> > Netlist::getAllFanIn(const std::string endNam
   return createVertexPtrVecVec(graph.getAllFanIn(vertex));
 }
 
+ReachabilityMatrix Netlist::getReachabilityMatrix(const std::string startPattern,
+                                                  const std::string endPattern) const {
+  return graph.getReachabilityMatrix(graph.getStartVertices(startPattern),
+                                     graph.getEndVertices(endPattern));
+}
+
+size_t Netlist::getFanOutDegree(const std::string startName) const {
+  auto vertex = getStartVertex(startName, Options::getInstance().isMatchAnyVertex());
+  if (vertex == graph.nullVertex()) {
+    throw Exception(std::string("could not find start vertex "+startName));
+  }
+  return graph.getfanOutDegree(vertex);
+}
+
+size_t Netlist::getFanInDegree(const std::string endName) const {
+  auto vertex = getEndVertex(endName, Options::getInstance().isMatchAnyVertex());
+  if (vertex == graph.nullVertex()) {
+    throw Exception(std::string("could not find end vertex "+endName));
+  }
+  return graph.getFanInDegree(vertex);
+}
+
+uint64_t Netlist::countPaths(Waypoints waypoints) const {
+  auto waypointIDs = readWaypoints(waypoints);
+  auto avoidPointIDs = readAvoidPoints(waypoints);
+  return graph.countPaths(waypointIDs, avoidPointIDs);
+}
+
+std::vector<std::pair<Vertex*, uint64_t> >
+Netlist::countFanOutPaths(const std::string startName) const {
+  auto vertex = getStartVertex(startName, Options::getInstance().isMatchAnyVertex());
+  if (vertex == graph.nullVertex()) {
+    throw Exception(std::string("could not find start vertex "+startName));
+  }
+  std::vector<std::pair<Vertex*, uint64_t> > result;
+  for (auto &count : graph.countFanOutPaths(vertex)) {
+    result.emplace_back(graph.getVertexPtr(count.first), count.second);
+  }
+  return result;
+}
+
+std::vector<std::pair<Vertex*, uint64_t> >
+Netlist::countFanInPaths(const std::string endName) const {
+  auto vertex = getEndVertex(endName, Options::getInstance().isMatchAnyVertex());
+  if (vertex == graph.nullVertex()) {
+    throw Exception(std::string("could not find end vertex "+endName));
+  }
+  std::vector<std::pair<Vertex*, uint64_t> > result;
+  for (auto &count : graph.countFanInPaths(vertex)) {
+    result.emplace_back(graph.getVertexPtr(count.first), count.second);
+  }
+  return result;
+}
+
 std::vector<std::reference_wrapper<const Vertex> >
 Netlist::getNamedVertices(const std::string pattern) const {
   // Collect vertices.
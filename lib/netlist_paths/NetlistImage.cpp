@@ -0,0 +1,359 @@
+#include <algorithm>
+#include <fstream>
+#include "netlist_paths/NetlistImage.hpp"
+
+using namespace netlist_paths;
+
+//===----------------------------------------------------------------------===//
+// ImageWriter
+//===----------------------------------------------------------------------===//
+
+ImageWriter::ImageWriter(const std::vector<File> &files,
+                         const std::vector<std::shared_ptr<DType>> &dtypes) :
+    netlistFiles(files), netlistDTypes(dtypes) {
+  for (auto &dtype : dtypes) {
+    metadata.addDType(dtype);
+  }
+}
+
+ImageString ImageWriter::addString(const std::string &value) {
+  if (strings.size() + value.size() + 1 > UINT32_MAX) {
+    throw Exception("netlist is too large for an image");
+  }
+  ImageString result{static_cast<uint32_t>(strings.size()),
+                     static_cast<uint32_t>(value.size())};
+  strings.append(value);
+  strings.push_back('\0');
+  return result;
+}
+
+uint32_t ImageWriter::encodeEdge(VertexID vertex, bool throughRegister) const {
+  if (outEdges.size() >= UINT32_MAX || inEdges.size() >= UINT32_MAX) {
+    throw Exception("netlist is too large for an image");
+  }
+  return CSRGraph::encodeEdge(vertex, throughRegister);
+}
+
+void ImageWriter::addVertex(const Vertex &vertex) {
+  if (astTypes.size() >= CSR_THROUGH_REGISTER - 1) {
+    throw Exception("netlist is too large for an image");
+  }
+  outOffsets.push_back(static_cast<uint32_t>(outEdges.size()));
+  inOffsets.push_back(static_cast<uint32_t>(inEdges.size()));
+  astTypes.push_back(static_cast<uint8_t>(vertex.getAstType()));
+  directions.push_back(static_cast<uint8_t>(vertex.getDirection()));
+  uint32_t vertexFlags = 0;
+  auto setFlag = [&vertexFlags](bool value, uint32_t flag) {
+    if (value) {
+      vertexFlags |= flag;
+    }
+  };
+  setFlag(vertex.isDeleted(),        IMAGE_FLAG_DELETED);
+  setFlag(vertex.isLogic(),          IMAGE_FLAG_LOGIC);
+  setFlag(vertex.isReg(),            IMAGE_FLAG_REG);
+  setFlag(vertex.isSrcReg(),         IMAGE_FLAG_SRC_REG);
+  setFlag(vertex.isDstReg(),         IMAGE_FLAG_DST_REG);
+  setFlag(vertex.isSrcRegAlias(),    IMAGE_FLAG_SRC_REG_ALIAS);
+  setFlag(vertex.isDstRegAlias(),    IMAGE_FLAG_DST_REG_ALIAS);
+  setFlag(vertex.isNet(),            IMAGE_FLAG_NET);
+  setFlag(vertex.isPort(),           IMAGE_FLAG_PORT);
+  setFlag(vertex.isCombStartPoint(), IMAGE_FLAG_COMB_START_POINT);
+  setFlag(vertex.isCombEndPoint(),   IMAGE_FLAG_COMB_END_POINT);
+  setFlag(vertex.isNamed(),          IMAGE_FLAG_NAMED);
+  setFlag(vertex.canIgnore(),        IMAGE_FLAG_CAN_IGNORE);
+  setFlag(vertex.isParameter(),      IMAGE_FLAG_PARAMETER);
+  setFlag(vertex.isPublic(),         IMAGE_FLAG_PUBLIC);
+  setFlag(vertex.isTop(),            IMAGE_FLAG_TOP);
+  flags.push_back(vertexFlags);
+  names.push_back(addString(vertex.getName()));
+  paramValues.push_back(addString(vertex.getParamValue()));
+  metadata.addDType(vertex.getDType());
+  dtypes.push_back(metadata.getDTypeID(vertex.getDType()));
+  auto &location = vertex.getLocation();
+  locations.push_back(ImageLocation{location.getFileIndex(),
+                                    location.getStartLine(),
+                                    location.getStartCol(),
+                                    location.getEndLine(),
+                                    location.getEndCol()});
+}
+
+void ImageWriter::write(const std::string &filename) {
+  outOffsets.push_back(static_cast<uint32_t>(outEdges.size()));
+  inOffsets.push_back(static_cast<uint32_t>(inEdges.size()));
+  // Sort the aliases by name so they can be binary searched.
+  std::sort(aliases.begin(), aliases.end());
+  std::vector<ImageAlias> imageAliases;
+  for (auto &alias : aliases) {
+    imageAliases.push_back(ImageAlias{addString(alias.first), alias.second});
+  }
+  // The metadata is a snapshot payload, so it can be read with SnapshotReader.
+  metadata.put<uint64_t>(netlistFiles.size());
+  for (auto &file : netlistFiles) {
+    metadata.putString(file.getFilename());
+    metadata.putString(file.getLanguage());
+  }
+  metadata.putDTypes();
+  metadata.put<uint64_t>(netlistDTypes.size());
+  for (auto &dtype : netlistDTypes) {
+    metadata.putDType(dtype);
+  }
+  auto &metadataPayload = metadata.getPayload();
+  // Lay out the sections after the header.
+  ImageHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::string body;
+  auto addSection = [&](ImageSection section, const void *data, std::size_t size) {
+    auto offset = sizeof(header) + body.size();
+    auto padding = (IMAGE_ALIGNMENT - offset % IMAGE_ALIGNMENT) % IMAGE_ALIGNMENT;
+    body.append(padding, '\0');
+    header.sections[static_cast<std::size_t>(section)] = {offset + padding, size};
+    body.append(static_cast<const char*>(data), size);
+  };
+  auto addVector = [&](ImageSection section, const auto &values) {
+    addSection(section, values.data(), values.size() * sizeof(values[0]));
+  };
+  addSection(ImageSection::METADATA, metadataPayload.data(), metadataPayload.size());
+  addVector(ImageSection::OUT_OFFSETS, outOffsets);
+  addVector(ImageSection::OUT_EDGES, outEdges);
+  addVector(ImageSection::IN_OFFSETS, inOffsets);
+  addVector(ImageSection::IN_EDGES, inEdges);
+  addVector(ImageSection::AST_TYPES, astTypes);
+  addVector(ImageSection::DIRECTIONS, directions);
+  addVector(ImageSection::FLAGS, flags);
+  addVector(ImageSection::NAMES, names);
+  addVector(ImageSection::PARAM_VALUES, paramValues);
+  addVector(ImageSection::DTYPES, dtypes);
+  addVector(ImageSection::LOCATIONS, locations);
+  addVector(ImageSection::ALIASES, imageAliases);
+  addSection(ImageSection::STRINGS, strings.data(), strings.size());
+  std::memcpy(header.magic, IMAGE_MAGIC, sizeof(header.magic));
+  header.version = IMAGE_VERSION;
+  header.byteOrder = SNAPSHOT_BYTE_ORDER;
+  header.fileSize = sizeof(header) + body.size();
+  header.numVertices = astTypes.size();
+  header.numEdges = outEdges.size();
+  header.numAliases = imageAliases.size();
+  std::ofstream outputFile(filename, std::ios::out | std::ios::binary);
+  if (!outputFile.is_open()) {
+    throw Exception(std::string("could not open file ")+filename);
+  }
+  outputFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  outputFile.write(body.data(), body.size());
+  if (!outputFile) {
+    throw Exception(std::string("could not write file ")+filename);
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// NetlistImage
+//===----------------------------------------------------------------------===//
+
+template<typename T>
+const T *NetlistImage::getSection(ImageSection section, std::size_t count) const {
+  auto &entry = header->sections[static_cast<std::size_t>(section)];
+  if (count > file.getSize() / sizeof(T) ||
+      entry.offset % IMAGE_ALIGNMENT != 0 ||
+      entry.offset > file.getSize() ||
+      entry.size > file.getSize() - entry.offset ||
+      entry.size != count * sizeof(T)) {
+    throw Exception("corrupt netlist image");
+  }
+  return reinterpret_cast<const T*>(file.getData() + entry.offset);
+}
+
+void NetlistImage::checkString(ImageString value) const {
+  if (static_cast<uint64_t>(value.offset) + value.length >= stringsSize ||
+      strings[value.offset + value.length] != '\0') {
+    throw Exception("corrupt netlist image");
+  }
+}
+
+NetlistImage::NetlistImage(const std::string &filename) :
+    file(filename, true) {
+  if (file.getSize() < sizeof(ImageHeader)) {
+    throw Exception(filename+" is not a netlist image");
+  }
+  header = reinterpret_cast<const ImageHeader*>(file.getData());
+  if (std::memcmp(header->magic, IMAGE_MAGIC, sizeof(header->magic)) != 0) {
+    throw Exception(filename+" is not a netlist image");
+  }
+  if (header->byteOrder != SNAPSHOT_BYTE_ORDER) {
+    throw Exception(filename+" was written on a machine with a different byte order");
+  }
+  if (header->version != IMAGE_VERSION) {
+    throw Exception((boost::format("%s has image version %d, expected %d")
+                       % filename % header->version % IMAGE_VERSION).str());
+  }
+  if (header->fileSize != file.getSize() ||
+      header->numVertices >= CSR_THROUGH_REGISTER ||
+      header->numEdges > UINT32_MAX) {
+    throw Exception(std::string("corrupt netlist image ")+filename);
+  }
+  // Locate the sections.
+  auto n = numVertices();
+  auto &stringsEntry = header->sections[static_cast<std::size_t>(ImageSection::STRINGS)];
+  auto &metadataEntry = header->sections[static_cast<std::size_t>(ImageSection::METADATA)];
+  edges = CSRGraph(n, header->numEdges,
+                   getSection<uint32_t>(ImageSection::OUT_OFFSETS, n + 1),
+                   getSection<uint32_t>(ImageSection::OUT_EDGES, header->numEdges),
+                   getSection<uint32_t>(ImageSection::IN_OFFSETS, n + 1),
+                   getSection<uint32_t>(ImageSection::IN_EDGES, header->numEdges));
+  astTypes    = getSection<uint8_t>(ImageSection::AST_TYPES, n);
+  directions  = getSection<uint8_t>(ImageSection::DIRECTIONS, n);
+  flags       = getSection<uint32_t>(ImageSection::FLAGS, n);
+  names       = getSection<ImageString>(ImageSection::NAMES, n);
+  paramValues = getSection<ImageString>(ImageSection::PARAM_VALUES, n);
+  dtypes      = getSection<uint32_t>(ImageSection::DTYPES, n);
+  locations   = getSection<ImageLocation>(ImageSection::LOCATIONS, n);
+  aliases     = getSection<ImageAlias>(ImageSection::ALIASES, header->numAliases);
+  strings     = getSection<char>(ImageSection::STRINGS, stringsEntry.size);
+  stringsSize = stringsEntry.size;
+  // Read the metadata.
+  metadata = std::make_unique<SnapshotReader>(
+      getSection<char>(ImageSection::METADATA, metadataEntry.size),
+      metadataEntry.size);
+  auto numFiles = metadata->getCount();
+  for (std::size_t i = 0; i < numFiles; i++) {
+    auto name = metadata->getString();
+    auto language = metadata->getString();
+    netlistFiles.push_back(File(name, language));
+  }
+  metadata->setNumFiles(numFiles);
+  metadata->getDTypes();
+  auto numDTypes = metadata->getCount();
+  for (std::size_t i = 0; i < numDTypes; i++) {
+    netlistDTypes.push_back(metadata->getDType());
+  }
+  if (!metadata->isEnd()) {
+    throw Exception(std::string("corrupt netlist image ")+filename);
+  }
+  // Check the structure of the graph, so that queries cannot read outside
+  // the mapping.
+  if (!edges.isValid()) {
+    throw Exception(std::string("corrupt netlist image ")+filename);
+  }
+  for (std::size_t vertex = 0; vertex < n; vertex++) {
+    if (astTypes[vertex] > static_cast<uint8_t>(VertexAstType::INVALID) ||
+        directions[vertex] > static_cast<uint8_t>(VertexDirection::INOUT)) {
+      throw Exception(std::string("corrupt netlist image ")+filename);
+    }
+    checkString(names[vertex]);
+    checkString(paramValues[vertex]);
+    metadata->getDType(dtypes[vertex]);
+    if (locations[vertex].fileID != Location::NULL_INDEX &&
+        locations[vertex].fileID >= netlistFiles.size()) {
+      throw Exception(std::string("corrupt netlist image ")+filename);
+    }
+  }
+  for (std::size_t i = 0; i < header->numAliases; i++) {
+    checkString(aliases[i].name);
+    if (aliases[i].vertex >= n) {
+      throw Exception(std::string("corrupt netlist image ")+filename);
+    }
+  }
+}
+
+bool NetlistImage::isGraphType(VertexID vertex, VertexNetlistType type) const {
+  switch (type) {
+    case VertexNetlistType::REG:           return hasFlag(vertex, IMAGE_FLAG_REG);
+    case VertexNetlistType::SRC_REG_ALIAS: return hasFlag(vertex, IMAGE_FLAG_SRC_REG_ALIAS);
+    case VertexNetlistType::DST_REG_ALIAS: return hasFlag(vertex, IMAGE_FLAG_DST_REG_ALIAS);
+    case VertexNetlistType::SRC_REG:       return hasFlag(vertex, IMAGE_FLAG_SRC_REG);
+    case VertexNetlistType::DST_REG:       return hasFlag(vertex, IMAGE_FLAG_DST_REG);
+    case VertexNetlistType::LOGIC:         return hasFlag(vertex, IMAGE_FLAG_LOGIC);
+    case VertexNetlistType::NET:           return hasFlag(vertex, IMAGE_FLAG_NET);
+    case VertexNetlistType::PORT:          return hasFlag(vertex, IMAGE_FLAG_PORT);
+    case VertexNetlistType::IS_NAMED:      return hasFlag(vertex, IMAGE_FLAG_NAMED);
+    // The following depend on the options, as in Vertex::isStartPoint,
+    // Vertex::isEndPoint and Vertex::isMidPoint.
+    case VertexNetlistType::START_POINT:
+      if (Options::getInstance().isRestrictStartPoints()) {
+        return hasFlag(vertex, IMAGE_FLAG_COMB_START_POINT);
+      }
+      return !hasFlag(vertex, IMAGE_FLAG_DST_REG |
+                              IMAGE_FLAG_DST_REG_ALIAS |
+                              IMAGE_FLAG_CAN_IGNORE |
+                              IMAGE_FLAG_DELETED);
+    case VertexNetlistType::END_POINT:
+      if (Options::getInstance().isRestrictEndPoints()) {
+        return hasFlag(vertex, IMAGE_FLAG_COMB_END_POINT);
+      }
+      return !hasFlag(vertex, IMAGE_FLAG_SRC_REG |
+                              IMAGE_FLAG_SRC_REG_ALIAS |
+                              IMAGE_FLAG_CAN_IGNORE |
+                              IMAGE_FLAG_DELETED);
+    case VertexNetlistType::MID_POINT:
+      if (Options::getInstance().shouldTraverseRegisters()) {
+        return hasFlag(vertex, IMAGE_FLAG_NAMED);
+      }
+      return !hasFlag(vertex, IMAGE_FLAG_COMB_START_POINT |
+                              IMAGE_FLAG_COMB_END_POINT |
+                              IMAGE_FLAG_CAN_IGNORE |
+                              IMAGE_FLAG_DELETED);
+    default:
+      return false;
+  }
+}
+
+VertexID NetlistImage::getAliasRegister(std::string_view name) const {
+  auto end = aliases + header->numAliases;
+  auto it = std::lower_bound(aliases, end, name,
+                             [this](const ImageAlias &alias, std::string_view value) {
+                               return getString(alias.name) < value; });
+  if (it != end && getString(it->name) == name) {
+    return it->vertex;
+  }
+  return boost::graph_traits<InternalGraph>::null_vertex();
+}
+
+bool NetlistImage::ownsVertex(const Vertex *vertex) const {
+  std::lock_guard<std::mutex> lock(vertexMutex);
+  return vertexIDs.count(vertex) != 0;
+}
+
+const Vertex &NetlistImage::getVertex(VertexID vertex) const {
+  std::lock_guard<std::mutex> lock(vertexMutex);
+  auto &entry = vertices[vertex];
+  if (!entry) {
+    auto &location = locations[vertex];
+    entry = std::make_unique<Vertex>(static_cast<VertexAstType>(astTypes[vertex]),
+                                     static_cast<VertexDirection>(directions[vertex]),
+                                     Location(location.fileID,
+                                              location.startLine,
+                                              location.startCol,
+                                              location.endLine,
+                                              location.endCol),
+                                     metadata->getDType(dtypes[vertex]),
+                                     std::string(getName(vertex)),
+                                     hasFlag(vertex, IMAGE_FLAG_PARAMETER),
+                                     std::string(getString(paramValues[vertex])),
+                                     hasFlag(vertex, IMAGE_FLAG_PUBLIC),
+                                     hasFlag(vertex, IMAGE_FLAG_TOP),
+                                     hasFlag(vertex, IMAGE_FLAG_DELETED));
+    vertexIDs.emplace(entry.get(), vertex);
+  }
+  return *entry;
+}
+
+//===----------------------------------------------------------------------===//
+// Reading and writing netlists.
+//===----------------------------------------------------------------------===//
+
+void netlist_paths::writeImage(const std::string &filename,
+                               const Graph &graph,
+                               const std::vector<File> &files,
+                               const std::vector<std::shared_ptr<DType>> &dtypes) {
+  ImageWriter writer(files, dtypes);
+  graph.writeImage(writer);
+  writer.write(filename);
+}
+
+void netlist_paths::readImage(const std::string &filename,
+                              Graph &graph,
+                              std::vector<File> &files,
+                              std::vector<std::shared_ptr<DType>> &dtypes) {
+  auto image = std::make_shared<const NetlistImage>(filename);
+  files = image->getFiles();
+  dtypes = image->getDTypes();
+  graph.setImage(image);
+}
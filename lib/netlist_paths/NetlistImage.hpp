@@ -0,0 +1,254 @@
+#ifndef NETLIST_PATHS_NETLIST_IMAGE_HPP
+#define NETLIST_PATHS_NETLIST_IMAGE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "netlist_paths/DTypes.hpp"
+#include "netlist_paths/Graph.hpp"
+#include "netlist_paths/Location.hpp"
+#include "netlist_paths/MappedFile.hpp"
+#include "netlist_paths/Snapshot.hpp"
+#include "netlist_paths/Vertex.hpp"
+
+namespace netlist_paths {
+
+/// The netlist image file format. An image is a read-only representation of
+/// a netlist that is queried directly from a shared memory mapping of the
+/// file, so that any number of processes on a host can use one physical copy
+/// of it. It starts with a fixed header, which gives the position and size of
+/// each section. All references within an image are offsets or indices, and
+/// values are stored in the byte order of the machine that wrote it.
+constexpr char IMAGE_MAGIC[8] = {'N', 'P', 'I', 'M', 'A', 'G', 'E', 0};
+constexpr uint32_t IMAGE_VERSION = 2;
+
+/// Sections are aligned so that their contents can be accessed in place.
+constexpr uint64_t IMAGE_ALIGNMENT = 8;
+
+/// Vertex attribute flags.
+constexpr uint32_t IMAGE_FLAG_DELETED          = 1U << 0;
+constexpr uint32_t IMAGE_FLAG_LOGIC            = 1U << 1;
+constexpr uint32_t IMAGE_FLAG_REG              = 1U << 2;
+constexpr uint32_t IMAGE_FLAG_SRC_REG          = 1U << 3;
+constexpr uint32_t IMAGE_FLAG_DST_REG          = 1U << 4;
+constexpr uint32_t IMAGE_FLAG_SRC_REG_ALIAS    = 1U << 5;
+constexpr uint32_t IMAGE_FLAG_DST_REG_ALIAS    = 1U << 6;
+constexpr uint32_t IMAGE_FLAG_NET              = 1U << 7;
+constexpr uint32_t IMAGE_FLAG_PORT             = 1U << 8;
+constexpr uint32_t IMAGE_FLAG_COMB_START_POINT = 1U << 9;
+constexpr uint32_t IMAGE_FLAG_COMB_END_POINT   = 1U << 10;
+constexpr uint32_t IMAGE_FLAG_NAMED            = 1U << 11;
+constexpr uint32_t IMAGE_FLAG_CAN_IGNORE       = 1U << 12;
+constexpr uint32_t IMAGE_FLAG_PARAMETER        = 1U << 13;
+constexpr uint32_t IMAGE_FLAG_PUBLIC           = 1U << 14;
+constexpr uint32_t IMAGE_FLAG_TOP              = 1U << 15;
+
+/// The sections of an image.
+enum class ImageSection : uint32_t {
+  METADATA,     ///< A snapshot payload with the files and data types.
+  OUT_OFFSETS,  ///< uint32_t[numVertices+1], indexing OUT_EDGES.
+  OUT_EDGES,    ///< uint32_t[numEdges], the targets of out edges, as in CSRGraph.
+  IN_OFFSETS,   ///< uint32_t[numVertices+1], indexing IN_EDGES.
+  IN_EDGES,     ///< uint32_t[numEdges], the sources of in edges, as in CSRGraph.
+  AST_TYPES,    ///< uint8_t[numVertices]
+  DIRECTIONS,   ///< uint8_t[numVertices]
+  FLAGS,        ///< uint32_t[numVertices]
+  NAMES,        ///< ImageString[numVertices]
+  PARAM_VALUES, ///< ImageString[numVertices]
+  DTYPES,       ///< uint32_t[numVertices], data type numbers in the metadata.
+  LOCATIONS,    ///< ImageLocation[numVertices]
+  ALIASES,      ///< ImageAlias[numAliases], sorted by name.
+  STRINGS,      ///< Null-terminated strings referred to by ImageString.
+  NUM_SECTIONS
+};
+
+constexpr std::size_t IMAGE_NUM_SECTIONS =
+    static_cast<std::size_t>(ImageSection::NUM_SECTIONS);
+
+struct ImageSectionEntry {
+  uint64_t offset;
+  uint64_t size;
+};
+
+struct ImageHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t byteOrder;
+  uint64_t fileSize;
+  uint64_t numVertices;
+  uint64_t numEdges;
+  uint64_t numAliases;
+  ImageSectionEntry sections[IMAGE_NUM_SECTIONS];
+};
+
+/// A reference to a string in the STRINGS section.
+struct ImageString {
+  uint32_t offset;
+  uint32_t length;
+};
+
+/// A location, referring to its file by its index in the source files of the
+/// netlist, which are held in the metadata.
+struct ImageLocation {
+  uint32_t fileID;
+  uint32_t startLine;
+  uint32_t startCol;
+  uint32_t endLine;
+  uint32_t endCol;
+};
+
+/// A register alias, mapping the name of an alias to a register vertex.
+struct ImageAlias {
+  ImageString name;
+  uint32_t vertex;
+};
+
+/// Lay out the sections of a netlist image.
+class ImageWriter {
+  SnapshotWriter metadata;
+  std::vector<File> netlistFiles;
+  std::vector<std::shared_ptr<DType>> netlistDTypes;
+  std::vector<uint32_t> outOffsets;
+  std::vector<uint32_t> outEdges;
+  std::vector<uint32_t> inOffsets;
+  std::vector<uint32_t> inEdges;
+  std::vector<uint8_t> astTypes;
+  std::vector<uint8_t> directions;
+  std::vector<uint32_t> flags;
+  std::vector<ImageString> names;
+  std::vector<ImageString> paramValues;
+  std::vector<uint32_t> dtypes;
+  std::vector<ImageLocation> locations;
+  std::vector<std::pair<std::string, uint32_t>> aliases;
+  std::string strings;
+
+  ImageString addString(const std::string &value);
+
+  uint32_t encodeEdge(VertexID vertex, bool throughRegister) const;
+
+public:
+  /// Start an image of a netlist with the specified source files and data
+  /// types.
+  ImageWriter(const std::vector<File> &files,
+              const std::vector<std::shared_ptr<DType>> &dtypes);
+
+  /// Add the next vertex of the graph.
+  void addVertex(const Vertex &vertex);
+
+  /// Add an out edge to the most recently added vertex.
+  void addOutEdge(VertexID target, bool throughRegister) {
+    outEdges.push_back(encodeEdge(target, throughRegister));
+  }
+
+  /// Add an in edge to the most recently added vertex.
+  void addInEdge(VertexID source, bool throughRegister) {
+    inEdges.push_back(encodeEdge(source, throughRegister));
+  }
+
+  /// Add a register alias.
+  void addAlias(const std::string &name, VertexID vertex) {
+    aliases.emplace_back(name, static_cast<uint32_t>(vertex));
+  }
+
+  /// Write the image to a file.
+  void write(const std::string &filename);
+};
+
+/// A read-only netlist image, queried in place from a shared memory mapping.
+/// Only the metadata (the source files and data types) is read when the
+/// image is opened. Vertex objects are created on demand, when they are
+/// returned from a query.
+class NetlistImage {
+  MappedFile file;
+  const ImageHeader *header;
+  CSRGraph edges;
+  const uint8_t *astTypes;
+  const uint8_t *directions;
+  const uint32_t *flags;
+  const ImageString *names;
+  const ImageString *paramValues;
+  const uint32_t *dtypes;
+  const ImageLocation *locations;
+  const ImageAlias *aliases;
+  const char *strings;
+  std::size_t stringsSize;
+  std::unique_ptr<SnapshotReader> metadata;
+  std::vector<File> netlistFiles;
+  std::vector<std::shared_ptr<DType>> netlistDTypes;
+  mutable std::unordered_map<VertexID, std::unique_ptr<Vertex>> vertices;
+  mutable std::unordered_map<const Vertex*, VertexID> vertexIDs;
+  mutable std::mutex vertexMutex;
+
+  template<typename T>
+  const T *getSection(ImageSection section, std::size_t count) const;
+
+  std::string_view getString(ImageString value) const {
+    return std::string_view(strings + value.offset, value.length);
+  }
+
+  bool hasFlag(VertexID vertex, uint32_t flag) const {
+    return (flags[vertex] & flag) != 0;
+  }
+
+  void checkString(ImageString value) const;
+
+public:
+  /// Map an image and check its header and structure.
+  ///
+  /// \param filename The path of the image file.
+  NetlistImage(const std::string &filename);
+
+  NetlistImage(const NetlistImage&) = delete;
+  NetlistImage &operator=(const NetlistImage&) = delete;
+
+  std::size_t numVertices() const { return header->numVertices; }
+  std::size_t numEdges() const { return header->numEdges; }
+
+  /// Return the source files of the netlist.
+  const std::vector<File> &getFiles() const { return netlistFiles; }
+
+  /// Return the data types of the netlist.
+  const std::vector<std::shared_ptr<DType>> &getDTypes() const { return netlistDTypes; }
+
+  /// Return the name of a vertex, which is followed by a null terminator.
+  std::string_view getName(VertexID vertex) const {
+    return getString(names[vertex]);
+  }
+
+  /// Match a vertex against a graph type, as Vertex::isGraphType does.
+  bool isGraphType(VertexID vertex, VertexNetlistType type) const;
+
+  /// Return the vertex of the register that a name is an alias of, or the
+  /// null vertex if it is not an alias.
+  VertexID getAliasRegister(std::string_view name) const;
+
+  /// Return a vertex object with the attributes of a vertex, creating it if
+  /// necessary. The object remains valid for the lifetime of the image.
+  const Vertex &getVertex(VertexID vertex) const;
+
+  /// Return true if a vertex object was created by getVertex().
+  bool ownsVertex(const Vertex *vertex) const;
+
+  /// Return the edges of the graph, which are a view of the mapping.
+  const CSRGraph &getGraph() const { return edges; }
+};
+
+/// Write a netlist to an image file.
+void writeImage(const std::string &filename,
+                const Graph &graph,
+                const std::vector<File> &files,
+                const std::vector<std::shared_ptr<DType>> &dtypes);
+
+/// Open a netlist image file.
+void readImage(const std::string &filename,
+               Graph &graph,
+               std::vector<File> &files,
+               std::vector<std::shared_ptr<DType>> &dtypes);
+
+} // End netlist_paths namespace.
+
+#endif // NETLIST_PATHS_NETLIST_IMAGE_HPP
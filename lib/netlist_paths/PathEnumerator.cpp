@@ -0,0 +1,90 @@
+#include <utility>
+#include <boost/log/trivial.hpp>
+#include "netlist_paths/Condensation.hpp"
+#include "netlist_paths/PathEnumerator.hpp"
+#include "netlist_paths/QueryWorkspace.hpp"
+
+using namespace netlist_paths;
+
+/// Each segment has its own workspace, since the walks of all the segments
+/// are in progress at once.
+PathEnumerator::PathEnumerator(const Graph &graph,
+                               VertexIDVec waypointIDs,
+                               const VertexIDVec &avoidPointIDs) :
+    graph(graph), waypointIDs(std::move(waypointIDs)),
+    aliasPath(graph.isAliasPath(this->waypointIDs)),
+    started(false), finished(false) {
+  if (aliasPath) {
+    return;
+  }
+  auto condensation = graph.getCondensation();
+  for (std::size_t i = 0; i < this->waypointIDs.size()-1; ++i) {
+    auto beginVertex = this->waypointIDs[i];
+    auto endVertex = this->waypointIDs[i+1];
+    BOOST_LOG_TRIVIAL(debug) << "Performing DFS from " << graph.getVertexName(beginVertex);
+    segments.push_back(std::make_unique<QueryWorkspace>());
+    graph.searchAllPaths(*segments.back(), *condensation,
+                         beginVertex, endVertex, avoidPointIDs);
+  }
+}
+
+PathEnumerator::~PathEnumerator() = default;
+
+/// Move the segments to their next combination of paths, like an odometer:
+/// the last segment moves to its next path, and when it has none left, it
+/// starts again from its first path and the segment before it moves on.
+bool PathEnumerator::advance() {
+  if (!started) {
+    started = true;
+    for (std::size_t i = 0; i < segments.size(); ++i) {
+      if (!graph.nextPath(*segments[i], waypointIDs[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+  for (auto i = segments.size(); i-- > 0;) {
+    if (graph.nextPath(*segments[i], waypointIDs[i])) {
+      return true;
+    }
+    if (i == 0) {
+      break;
+    }
+    // The segment had a path before, so it has one again from the start.
+    graph.startPathWalk(*segments[i], waypointIDs[i], waypointIDs[i+1]);
+    graph.nextPath(*segments[i], waypointIDs[i]);
+  }
+  return false;
+}
+
+bool PathEnumerator::next() {
+  if (finished) {
+    return false;
+  }
+  // Special case for paths between aliases of the same variable.
+  if (aliasPath) {
+    if (started) {
+      finished = true;
+      path.clear();
+      return false;
+    }
+    started = true;
+    path = {graph.getVertexPtr(waypointIDs[0]), graph.getVertexPtr(waypointIDs[1])};
+    return true;
+  }
+  if (!advance()) {
+    finished = true;
+    path.clear();
+    return false;
+  }
+  // Join the segment paths, each of which is held from its finish back to
+  // its start, and shares its finish with the start of the next segment.
+  path.clear();
+  for (auto &segment : segments) {
+    for (auto i = segment->path.size(); i-- > 1;) {
+      path.push_back(graph.getVertexPtr(segment->path[i]));
+    }
+  }
+  path.push_back(graph.getVertexPtr(waypointIDs.back()));
+  return true;
+}
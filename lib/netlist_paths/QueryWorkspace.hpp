@@ -0,0 +1,156 @@
+#ifndef NETLIST_PATHS_QUERY_WORKSPACE_HPP
+#define NETLIST_PATHS_QUERY_WORKSPACE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "netlist_paths/Graph.hpp"
+
+namespace netlist_paths {
+
+/// The scratch state of graph searches, which is reused between queries so
+/// that they do not allocate once the buffers have grown to the size of the
+/// graph. Per-vertex state is only valid when the vertex is stamped with the
+/// current epoch, so starting a new search is O(1) rather than clearing
+/// arrays the size of the graph. Each thread has its own workspace.
+class QueryWorkspace {
+  std::vector<uint32_t> stamps[2];
+  std::vector<uint32_t> parents[2];
+  std::vector<uint32_t> parentHeads;
+  std::vector<uint32_t> parentTails;
+  std::vector<uint8_t> onPath;
+  uint32_t epoch;
+
+public:
+  static constexpr uint32_t NONE = UINT32_MAX;
+
+  /// Marks the start vertex at the end of a path that has been found but not
+  /// yet reported, in place of its next parent list entry.
+  static constexpr uint32_t FOUND = UINT32_MAX - 1;
+
+  /// An entry in a list of the parents of a vertex.
+  struct ParentEntry {
+    uint32_t parent;
+    uint32_t next;
+  };
+
+  /// The parent lists of all vertices, which are recorded by searches that
+  /// keep every edge.
+  std::vector<ParentEntry> parentEntries;
+
+  /// The stack of a depth-first search: each entry is a vertex and the
+  /// index of its next edge to examine.
+  std::vector<std::pair<VertexID, uint32_t>> stack;
+
+  /// The vertices visited by side 0 of a search, in the order they were
+  /// visited, so that results can be collected from them without scanning
+  /// the whole graph.
+  VertexIDVec visited;
+
+  /// The frontiers of a breadth-first search, in each direction.
+  std::vector<VertexID> frontiers[2];
+  std::vector<VertexID> nextFrontier;
+
+  /// A buffer for a path under construction, from the finish vertex back
+  /// towards the start, and the next parent list entry to follow from each
+  /// vertex on it.
+  VertexIDVec path;
+  std::vector<uint32_t> pathEntries;
+
+  /// The number of paths to each vertex, which is valid for vertices visited
+  /// by a search that counts paths. It is only sized by that search, so other
+  /// searches do not pay for it.
+  std::vector<uint64_t> counts;
+
+  QueryWorkspace() : epoch(0) {}
+
+  QueryWorkspace(const QueryWorkspace&) = delete;
+  QueryWorkspace &operator=(const QueryWorkspace&) = delete;
+
+  /// Return the workspace of the calling thread.
+  static QueryWorkspace &get() {
+    static thread_local QueryWorkspace workspace;
+    return workspace;
+  }
+
+  /// Start a new search of a graph, forgetting the state of any previous
+  /// search.
+  void reset(std::size_t numVertices) {
+    if (stamps[0].size() < numVertices) {
+      for (auto side : {0, 1}) {
+        stamps[side].resize(numVertices, 0);
+        parents[side].resize(numVertices, NONE);
+      }
+      parentHeads.resize(numVertices, NONE);
+      parentTails.resize(numVertices, NONE);
+      onPath.resize(numVertices, 0);
+    }
+    if (++epoch == 0) {
+      // The epoch has wrapped, so old stamps could appear to be current.
+      for (auto side : {0, 1}) {
+        std::fill(stamps[side].begin(), stamps[side].end(), 0);
+      }
+      epoch = 1;
+    }
+    parentEntries.clear();
+    visited.clear();
+    stack.clear();
+    frontiers[0].clear();
+    frontiers[1].clear();
+    nextFrontier.clear();
+    path.clear();
+    pathEntries.clear();
+  }
+
+  /// Return true if a vertex has been visited by one side of the search.
+  /// A bidirectional search uses side 0 for the forward direction and side 1
+  /// for the reverse direction. Other searches only use side 0.
+  bool isVisited(int side, VertexID vertex) const {
+    return stamps[side][vertex] == epoch;
+  }
+
+  /// Mark a vertex as visited, with the vertex it was reached from, or NONE.
+  void visit(int side, VertexID vertex, uint32_t parent) {
+    stamps[side][vertex] = epoch;
+    parents[side][vertex] = parent;
+    if (side == 0) {
+      parentHeads[vertex] = NONE;
+      parentTails[vertex] = NONE;
+      visited.push_back(vertex);
+    }
+  }
+
+  /// Return the vertex that a visited vertex was reached from, or NONE.
+  uint32_t getParent(int side, VertexID vertex) const {
+    return parents[side][vertex];
+  }
+
+  /// Add a parent to the end of the parent list of a vertex visited by side
+  /// 0 of the search.
+  void addParent(VertexID vertex, VertexID parent) {
+    auto entry = static_cast<uint32_t>(parentEntries.size());
+    parentEntries.push_back(ParentEntry{static_cast<uint32_t>(parent), NONE});
+    if (parentTails[vertex] == NONE) {
+      parentHeads[vertex] = entry;
+    } else {
+      parentEntries[parentTails[vertex]].next = entry;
+    }
+    parentTails[vertex] = entry;
+  }
+
+  /// Return the index of the first entry in the parent list of a vertex, or
+  /// NONE.
+  uint32_t getParentHead(VertexID vertex) const {
+    return isVisited(0, vertex) ? parentHeads[vertex] : NONE;
+  }
+
+  /// Per-vertex flags for the vertices of a path under construction, which
+  /// must be cleared as vertices are removed from the path.
+  bool isOnPath(VertexID vertex) const { return onPath[vertex] != 0; }
+  void setOnPath(VertexID vertex, bool value) { onPath[vertex] = value; }
+};
+
+} // End netlist_paths namespace.
+
+#endif // NETLIST_PATHS_QUERY_WORKSPACE_HPP
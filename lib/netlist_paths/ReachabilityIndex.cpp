@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <numeric>
+#include "netlist_paths/ReachabilityIndex.hpp"
+
+using namespace netlist_paths;
+
+/// Return true if two sorted lists have an element in common.
+static bool intersects(const uint32_t *a, const uint32_t *aEnd,
+                       const uint32_t *b, const uint32_t *bEnd) {
+  while (a != aEnd && b != bEnd) {
+    if (*a == *b) {
+      return true;
+    }
+    if (*a < *b) {
+      a++;
+    } else {
+      b++;
+    }
+  }
+  return false;
+}
+
+/// Flatten a list of lists into offsets and values.
+static void flatten(const std::vector<std::vector<uint32_t>> &lists,
+                    std::vector<uint32_t> &offsets,
+                    std::vector<uint32_t> &values) {
+  offsets.reserve(lists.size() + 1);
+  for (auto &list : lists) {
+    offsets.push_back(static_cast<uint32_t>(values.size()));
+    values.insert(values.end(), list.begin(), list.end());
+  }
+  offsets.push_back(static_cast<uint32_t>(values.size()));
+}
+
+ReachabilityIndex::ReachabilityIndex(std::shared_ptr<const Condensation> condensation) :
+    condensation(condensation) {
+  auto numComponents = condensation->getNumComponents();
+  // Choose hubs in order of decreasing degree.
+  std::vector<uint32_t> order(numComponents);
+  std::iota(order.begin(), order.end(), 0);
+  auto degree = [&](uint32_t component) {
+    return static_cast<uint64_t>(condensation->numAdjacent(component, false) + 1) *
+           (condensation->numAdjacent(component, true) + 1);
+  };
+  std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+    return degree(a) > degree(b);
+  });
+  // Label the components with a pruned breadth-first search from each hub,
+  // forwards and then backwards. Since the hubs are processed in order, each
+  // label list is built in sorted order.
+  std::vector<std::vector<uint32_t>> outLists(numComponents);
+  std::vector<std::vector<uint32_t>> inLists(numComponents);
+  auto isCovered = [&](uint32_t from, uint32_t to) {
+    auto &out = outLists[from];
+    auto &in = inLists[to];
+    return intersects(out.data(), out.data() + out.size(),
+                      in.data(), in.data() + in.size());
+  };
+  std::vector<uint32_t> stamps(numComponents, 0);
+  uint32_t epoch = 0;
+  std::vector<uint32_t> queue;
+  auto search = [&](uint32_t hub, uint32_t rank, bool reverse) {
+    auto &labels = reverse ? outLists : inLists;
+    epoch++;
+    queue.clear();
+    queue.push_back(hub);
+    stamps[hub] = epoch;
+    for (std::size_t i = 0; i < queue.size(); i++) {
+      auto component = queue[i];
+      if (component != hub &&
+          (reverse ? isCovered(component, hub) : isCovered(hub, component))) {
+        continue;
+      }
+      labels[component].push_back(rank);
+      condensation->forEachAdjacent(component, reverse, [&](uint32_t next) {
+        if (stamps[next] != epoch) {
+          stamps[next] = epoch;
+          queue.push_back(next);
+        }
+      });
+    }
+  };
+  for (uint32_t rank = 0; rank < numComponents; rank++) {
+    search(order[rank], rank, false);
+    search(order[rank], rank, true);
+  }
+  flatten(outLists, outOffsets, outLabels);
+  flatten(inLists, inOffsets, inLabels);
+}
+
+bool ReachabilityIndex::reaches(VertexID start, VertexID finish) const {
+  auto from = condensation->getComponent(start);
+  auto to = condensation->getComponent(finish);
+  if (from == to) {
+    return true;
+  }
+  return intersects(outLabels.data() + outOffsets[from],
+                    outLabels.data() + outOffsets[from+1],
+                    inLabels.data() + inOffsets[to],
+                    inLabels.data() + inOffsets[to+1]);
+}
+
+std::size_t ReachabilityIndex::memoryUsage() const {
+  return (outOffsets.size() + outLabels.size() +
+          inOffsets.size() + inLabels.size()) * sizeof(uint32_t);
+}
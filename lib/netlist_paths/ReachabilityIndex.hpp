@@ -0,0 +1,54 @@
+#ifndef NETLIST_PATHS_REACHABILITY_INDEX_HPP
+#define NETLIST_PATHS_REACHABILITY_INDEX_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "netlist_paths/Condensation.hpp"
+#include "netlist_paths/Graph.hpp"
+
+namespace netlist_paths {
+
+/// An index that answers whether one vertex can reach another without
+/// searching the graph. The graph is condensed into a DAG of its
+/// strongly-connected components, which is then labelled with pruned 2-hop
+/// labels: each component has a sorted list of the hub components it can
+/// reach, and a sorted list of the hub components that can reach it, and one
+/// component reaches another if and only if their lists share a hub. Hubs are
+/// chosen in order of decreasing degree, and each hub is only added to the
+/// labels of components that are not already covered by an earlier one,
+/// which keeps the labels small on netlist graphs.
+///
+/// The index reflects whether edges through registers were traversed when it
+/// was built, and does not account for avoid points.
+class ReachabilityIndex {
+  std::shared_ptr<const Condensation> condensation;
+  std::vector<uint32_t> outOffsets;
+  std::vector<uint32_t> outLabels;
+  std::vector<uint32_t> inOffsets;
+  std::vector<uint32_t> inLabels;
+
+public:
+  /// Build an index of a graph from its condensation.
+  ///
+  /// \param condensation The condensation of the graph to index.
+  ReachabilityIndex(std::shared_ptr<const Condensation> condensation);
+
+  /// Return true if the index was built with edges through registers.
+  bool isTraverseRegisters() const { return condensation->isTraverseRegisters(); }
+
+  /// Return the number of strongly-connected components in the graph.
+  std::size_t getNumComponents() const { return condensation->getNumComponents(); }
+
+  /// Return true if there is a path from the start vertex to the finish
+  /// vertex.
+  bool reaches(VertexID start, VertexID finish) const;
+
+  /// Return the number of bytes used by the index, excluding the
+  /// condensation.
+  std::size_t memoryUsage() const;
+};
+
+} // End netlist_paths namespace.
+
+#endif // NETLIST_PATHS_REACHABILITY_INDEX_HPP
@@ -0,0 +1,129 @@
+#include <algorithm>
+#include "netlist_paths/Exception.hpp"
+#include "netlist_paths/ReachabilityMatrix.hpp"
+
+using namespace netlist_paths;
+
+bool ReachabilityMatrix::Bitmap::test(std::size_t line, std::size_t index) const {
+  auto begin = blocks.begin() + offsets[line];
+  auto end = blocks.begin() + offsets[line+1];
+  auto block = std::lower_bound(begin, end, static_cast<uint32_t>(index / 64));
+  if (block == end || *block != index / 64) {
+    return false;
+  }
+  return (words[block - blocks.begin()] >> (index % 64)) & 1;
+}
+
+std::vector<std::size_t> ReachabilityMatrix::Bitmap::getIndices(std::size_t line) const {
+  std::vector<std::size_t> indices;
+  for (auto i = offsets[line]; i < offsets[line+1]; i++) {
+    for (auto word = words[i]; word != 0; word &= word - 1) {
+      std::size_t bit = 0;
+      while (!((word >> bit) & 1)) {
+        bit++;
+      }
+      indices.push_back(static_cast<std::size_t>(blocks[i]) * 64 + bit);
+    }
+  }
+  return indices;
+}
+
+/// Group the entries by line with a counting sort, which keeps the order of
+/// the entries of each line.
+ReachabilityMatrix::Bitmap
+ReachabilityMatrix::groupEntries(const std::vector<Entry> &entries,
+                                 std::size_t numLines) {
+  Bitmap bitmap;
+  bitmap.offsets.assign(numLines + 1, 0);
+  for (auto &entry : entries) {
+    bitmap.offsets[entry.line + 1]++;
+  }
+  for (std::size_t line = 0; line < numLines; line++) {
+    bitmap.offsets[line + 1] += bitmap.offsets[line];
+  }
+  bitmap.blocks.resize(entries.size());
+  bitmap.words.resize(entries.size());
+  std::vector<uint32_t> next(bitmap.offsets.begin(), bitmap.offsets.end() - 1);
+  for (auto &entry : entries) {
+    auto i = next[entry.line]++;
+    bitmap.blocks[i] = entry.block;
+    bitmap.words[i] = entry.word;
+  }
+  return bitmap;
+}
+
+/// The entries of each column are in increasing order of block. The rows are
+/// built from the columns one block of 64 columns at a time, by gathering the
+/// bits of each row in the block into a word.
+void ReachabilityMatrix::setColumns(const std::vector<Entry> &columnEntries) {
+  columns = groupEntries(columnEntries, endPoints.size());
+  std::vector<Entry> rowEntries;
+  rowEntries.reserve(columnEntries.size());
+  std::vector<uint64_t> rowWords(startPoints.size(), 0);
+  std::vector<uint32_t> touched;
+  for (std::size_t firstColumn = 0; firstColumn < endPoints.size(); firstColumn += 64) {
+    auto lastColumn = std::min(firstColumn + 64, endPoints.size());
+    for (auto column = firstColumn; column < lastColumn; column++) {
+      for (auto row : columns.getIndices(column)) {
+        if (rowWords[row] == 0) {
+          touched.push_back(static_cast<uint32_t>(row));
+        }
+        rowWords[row] |= uint64_t(1) << (column % 64);
+      }
+    }
+    for (auto row : touched) {
+      rowEntries.push_back({row, static_cast<uint32_t>(firstColumn / 64), rowWords[row]});
+      rowWords[row] = 0;
+    }
+    touched.clear();
+  }
+  rows = groupEntries(rowEntries, startPoints.size());
+}
+
+bool ReachabilityMatrix::reaches(std::size_t startIndex, std::size_t endIndex) const {
+  if (startIndex >= startPoints.size() || endIndex >= endPoints.size()) {
+    throw Exception("reachability matrix index out of range");
+  }
+  return rows.test(startIndex, endIndex);
+}
+
+std::vector<Vertex*> ReachabilityMatrix::getRow(std::size_t startIndex) const {
+  if (startIndex >= startPoints.size()) {
+    throw Exception("reachability matrix row out of range");
+  }
+  std::vector<Vertex*> result;
+  for (auto column : rows.getIndices(startIndex)) {
+    result.push_back(endPoints[column]);
+  }
+  return result;
+}
+
+std::vector<Vertex*> ReachabilityMatrix::getColumn(std::size_t endIndex) const {
+  if (endIndex >= endPoints.size()) {
+    throw Exception("reachability matrix column out of range");
+  }
+  std::vector<Vertex*> result;
+  for (auto row : columns.getIndices(endIndex)) {
+    result.push_back(startPoints[row]);
+  }
+  return result;
+}
+
+std::size_t ReachabilityMatrix::count() const {
+  std::size_t total = 0;
+  for (auto word : rows.words) {
+    for (; word != 0; word &= word - 1) {
+      total++;
+    }
+  }
+  return total;
+}
+
+std::size_t ReachabilityMatrix::memoryUsage() const {
+  std::size_t total = 0;
+  for (auto bitmap : {&rows, &columns}) {
+    total += (bitmap->offsets.size() + bitmap->blocks.size()) * sizeof(uint32_t) +
+             bitmap->words.size() * sizeof(uint64_t);
+  }
+  return total;
+}
@@ -1,93 +1,26 @@
-#include <fstream>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <functional>
 #include <iostream>
 #include <map>
+#include <string_view>
 #include <boost/format.hpp>
 
+#include "netlist_paths/AstNode.hpp"
 #include "netlist_paths/DTypes.hpp"
 #include "netlist_paths/Exception.hpp"
+#include "netlist_paths/MappedFile.hpp"
 #include "netlist_paths/Options.hpp"
 #include "netlist_paths/ReadVerilatorXML.hpp"
+#include "netlist_paths/ThreadPool.hpp"
+#include "netlist_paths/XMLStream.hpp"
 
 using namespace netlist_paths;
 
-enum class AstNode {
-  ALWAYS,
-  ALWAYS_PUBLIC,
-  ASSIGN,
-  ASSIGN_ALIAS,
-  ASSIGN_DLY,
-  ASSIGN_W,
-  BASIC_DTYPE,
-  CONST,
-  CONT_ASSIGN,
-  C_FUNC,
-  ENUM,
-  IFACE_REF_DTYPE,
-  INITIAL,
-  INSTANCE,
-  INTF_REF,
-  MEMBER_DTYPE,
-  MODULE,
-  PACKED_ARRAY,
-  RANGE,
-  REF_DTYPE,
-  SCOPE,
-  SEN_GATE,
-  SEN_ITEM,
-  STRUCT_DTYPE,
-  TOP_SCOPE,
-  TYPEDEF,
-  TYPE_TABLE,
-  UNION_DTYPE,
-  UNPACKED_ARRAY,
-  VAR,
-  VAR_REF,
-  VAR_SCOPE,
-  INVALID
-};
-
-/// Convert a string name into an AstNode type.
-static AstNode resolveNode(const char *name) {
-  static std::map<std::string, AstNode> mappings {
-      { "always",           AstNode::ALWAYS },
-      { "alwayspublic",     AstNode::ALWAYS_PUBLIC },
-      { "assign",           AstNode::ASSIGN },
-      { "assignalias",      AstNode::ASSIGN_ALIAS },
-      { "assigndly",        AstNode::ASSIGN_DLY },
-      { "assignw",          AstNode::ASSIGN_W },
-      { "basicdtype",       AstNode::BASIC_DTYPE },
-      { "cfunc",            AstNode::C_FUNC },
-      { "const",            AstNode::CONST },
-      { "contassign",       AstNode::CONT_ASSIGN },
-      { "enumdtype",        AstNode::ENUM },
-      { "ifacerefdtype",    AstNode::IFACE_REF_DTYPE },
-      { "initial",          AstNode::INITIAL },
-      { "instance",         AstNode::INSTANCE },
-      { "intfref",          AstNode::INTF_REF },
-      { "memberdtype",      AstNode::MEMBER_DTYPE },
-      { "module",           AstNode::MODULE },
-      { "packarraydtype",   AstNode::PACKED_ARRAY },
-      { "refdtype",         AstNode::REF_DTYPE },
-      { "scope",            AstNode::SCOPE },
-      { "sengate",          AstNode::SEN_GATE },
-      { "senitem",          AstNode::SEN_ITEM },
-      { "structdtype",      AstNode::STRUCT_DTYPE },
-      { "topscope",         AstNode::TOP_SCOPE },
-      { "typedef",          AstNode::TYPEDEF },
-      { "typetable",        AstNode::TYPE_TABLE },
-      { "uniondtype",       AstNode::UNION_DTYPE },
-      { "unpackarraydtype", AstNode::UNPACKED_ARRAY },
-      { "var",              AstNode::VAR },
-      { "varref",           AstNode::VAR_REF },
-      { "varscope",         AstNode::VAR_SCOPE },
-  };
-  auto it = mappings.find(name);
-  return (it != mappings.end()) ? it->second : AstNode::INVALID;
-}
-
 void ReadVerilatorXML::dispatchVisitor(XMLNode *node) {
   // Handle node by type.
-  switch (resolveNode(node->name())) {
+  switch (resolveNode(std::string_view(node->name(), node->name_size()))) {
   case AstNode::ALWAYS:          visitAlways(node);                      break;
   case AstNode::ALWAYS_PUBLIC:   visitAlways(node);                      break;
   case AstNode::ASSIGN:          visitAssign(node);                      break;
@@ -102,7 +35,7 @@ void ReadVerilatorXML::dispatchVisitor(XMLNode *node) {
   case AstNode::INITIAL:         visitInitial(node);                     break;
   case AstNode::INSTANCE:        visitInstance(node);                    break;
   case AstNode::INTF_REF:        visitInterfaceRef(node);                break;
-  case AstNode::MEMBER_DTYPE:    visitMemberDType(node);                 break;
+  case AstNode::MEMBER_DTYPE:    /* Visited by the parent aggregate. */  break;
   case AstNode::PACKED_ARRAY:    visitArrayDType(node, true);            break;
   case AstNode::REF_DTYPE:       visitRefDtype(node);                    break;
   case AstNode::SCOPE:           visitScope(node);                       break;
@@ -123,6 +56,226 @@ void ReadVerilatorXML::dispatchVisitor(XMLNode *node) {
   }
 }
 
+//===----------------------------------------------------------------------===//
+// Graph construction. When the graph is built by several threads, variables
+// and data types are read first, by a single thread that visits only var,
+// varscope and dtype elements, then top-level statements are elaborated in
+// parallel. Each thread records graph operations, which are applied to the
+// graph in document order, so that the resulting graph is identical to one
+// built by a single thread.
+//===----------------------------------------------------------------------===//
+
+VertexID ReadVerilatorXML::addVarVertex(VertexDirection direction,
+                                        Location location,
+                                        const std::string &name,
+                                        bool isParam,
+                                        const std::string &paramValue,
+                                        bool isPublic) {
+  if (mode == BuildMode::VARS) {
+    auto slot = varVertices.size();
+    varVertices.emplace_back(VertexAstType::VAR, direction, location, nullptr,
+                             name, isParam, paramValue, isPublic);
+    ops->push_back(GraphOp{GraphOp::Kind::ADD_VAR_VERTEX, VertexAstType::VAR,
+                           Location(), slot, 0});
+    return slot | VAR_SLOT_TAG;
+  }
+  return netlist.addVarVertex(VertexAstType::VAR, direction, location, nullptr,
+                              name, isParam, paramValue, isPublic);
+}
+
+VertexID ReadVerilatorXML::addLogicVertex(VertexAstType type,
+                                          Location location) {
+  if (mode == BuildMode::STATEMENTS) {
+    ops->push_back(GraphOp{GraphOp::Kind::ADD_LOGIC_VERTEX, type, location,
+                           0, 0});
+    return numLocalVertices++;
+  }
+  return netlist.addLogicVertex(type, location);
+}
+
+void ReadVerilatorXML::addEdge(VertexID src, VertexID dst) {
+  if (mode == BuildMode::DIRECT) {
+    netlist.addEdge(src, dst);
+  } else {
+    ops->push_back(GraphOp{GraphOp::Kind::ADD_EDGE, VertexAstType::VAR,
+                           Location(), src, dst});
+  }
+}
+
+void ReadVerilatorXML::setVertexDstReg(VertexID vertex) {
+  if (mode == BuildMode::DIRECT) {
+    netlist.setVertexDstReg(vertex);
+  } else {
+    ops->push_back(GraphOp{GraphOp::Kind::SET_DST_REG, VertexAstType::VAR,
+                           Location(), vertex, 0});
+  }
+}
+
+void ReadVerilatorXML::setVertexDirection(VertexID vertex,
+                                          VertexDirection direction) {
+  if (mode == BuildMode::VARS) {
+    varVertices[vertex & ~VAR_SLOT_TAG].setDirection(direction);
+  } else {
+    netlist.setVertexDirection(vertex, direction);
+  }
+}
+
+const Vertex &ReadVerilatorXML::getVertex(VertexID vertex) const {
+  if (mode == BuildMode::VARS) {
+    return varVertices[vertex & ~VAR_SLOT_TAG];
+  }
+  return netlist.getVertex(vertex);
+}
+
+/// Return true if a variable is declared before the current point in the
+/// netlist. Only statement threads can see variables declared later.
+bool ReadVerilatorXML::isVarVisible(VertexID vertex) const {
+  if (mode == BuildMode::STATEMENTS) {
+    return (vertex & ~VAR_SLOT_TAG) < visibleVarSlots;
+  }
+  return true;
+}
+
+std::string_view ReadVerilatorXML::getVisibleTopName() const {
+  if (mode == BuildMode::STATEMENTS && visibleVarSlots <= tables->topNameSlot) {
+    return std::string_view();
+  }
+  return tables->topName;
+}
+
+/// Record the variable operations up to the end of a var element.
+void ReadVerilatorXML::recordVarElement() {
+  if (mode == BuildMode::VARS) {
+    varElementMarks.emplace_back(varOps.size(), varVertices.size());
+  }
+}
+
+/// Apply the variable operations of a var element encountered while
+/// elaborating a statement.
+void ReadVerilatorXML::applyVarElement() {
+  auto &mark = tables->varElementMarks[varElementIndex++];
+  ops->push_back(GraphOp{GraphOp::Kind::APPLY_VAR_OPS, VertexAstType::VAR,
+                         Location(), mark.first, 0});
+  visibleVarSlots = mark.second;
+}
+
+/// Read the var, varscope and dtype elements of a statement, in document
+/// order, without elaborating the statement itself.
+void ReadVerilatorXML::visitVarElements(XMLNode *node) {
+  for (XMLNode *child = node->first_node();
+       child; child = child->next_sibling()) {
+    switch (resolveNode(std::string_view(child->name(), child->name_size()))) {
+    case AstNode::VAR:
+    case AstNode::VAR_SCOPE:
+    case AstNode::BASIC_DTYPE:
+    case AstNode::ENUM:
+    case AstNode::IFACE_REF_DTYPE:
+    case AstNode::PACKED_ARRAY:
+    case AstNode::REF_DTYPE:
+    case AstNode::STRUCT_DTYPE:
+    case AstNode::UNION_DTYPE:
+    case AstNode::UNPACKED_ARRAY:  dispatchVisitor(child);  break;
+    case AstNode::MEMBER_DTYPE:    /* Visited by the parent. */ break;
+    default:                       visitVarElements(child); break;
+    }
+  }
+}
+
+/// Elaborate a range of top-level statements, recording the index of the
+/// first operation of each.
+void ReadVerilatorXML::buildStatements(const StatementItem *begin,
+                                       const StatementItem *end,
+                                       std::vector<std::size_t> &itemOpStarts) {
+  for (auto item = begin; item != end; ++item) {
+    itemOpStarts.push_back(ops->size());
+    varElementIndex = item->varElementIndex;
+    visibleVarSlots = item->visibleVarSlots;
+    dispatchVisitor(item->node);
+  }
+}
+
+void ReadVerilatorXML::visitModuleParallel(XMLNode *node, std::size_t numJobs) {
+  // Read the variables and collect the top-level statements.
+  mode = BuildMode::VARS;
+  ops = &varOps;
+  visitModule(node);
+  mode = BuildMode::DIRECT;
+  ops = nullptr;
+  // Elaborate contiguous ranges of statements in parallel, on the shared
+  // thread pool, which reports the first error in document order.
+  struct Partition {
+    std::vector<GraphOp> ops;
+    std::vector<std::size_t> itemOpStarts;
+    std::size_t begin;
+    std::size_t end;
+  };
+  auto numPartitions = std::min(numJobs, statementItems.size());
+  std::vector<Partition> partitions(numPartitions);
+  for (std::size_t i = 0; i < numPartitions; i++) {
+    partitions[i].begin = (statementItems.size() * i) / numPartitions;
+    partitions[i].end = (statementItems.size() * (i + 1)) / numPartitions;
+  }
+  ThreadPool::runShared(numPartitions, [this, &partitions](std::size_t i) {
+    auto &partition = partitions[i];
+    ReadVerilatorXML worker(*this, partition.ops);
+    worker.buildStatements(statementItems.data() + partition.begin,
+                           statementItems.data() + partition.end,
+                           partition.itemOpStarts);
+  });
+  // Apply the operations in document order.
+  std::vector<VertexID> varVertexIDs(varVertices.size(), netlist.nullVertex());
+  std::vector<VertexID> localVertexIDs;
+  std::size_t varOpIndex = 0;
+  auto getVertexID = [&](VertexID vertex) {
+    return (vertex & VAR_SLOT_TAG) ? varVertexIDs[vertex & ~VAR_SLOT_TAG]
+                                   : localVertexIDs[vertex];
+  };
+  std::function<void(const GraphOp&)> applyOp;
+  auto applyVarOps = [&](std::size_t end) {
+    while (varOpIndex < end) {
+      applyOp(varOps[varOpIndex++]);
+    }
+  };
+  applyOp = [&](const GraphOp &op) {
+    switch (op.kind) {
+    case GraphOp::Kind::ADD_VAR_VERTEX:
+      varVertexIDs[op.src] = netlist.addVertex(varVertices[op.src]);
+      break;
+    case GraphOp::Kind::ADD_LOGIC_VERTEX:
+      localVertexIDs.push_back(netlist.addLogicVertex(op.astType, op.location));
+      break;
+    case GraphOp::Kind::ADD_EDGE:
+      netlist.addEdge(getVertexID(op.src), getVertexID(op.dst));
+      break;
+    case GraphOp::Kind::SET_DST_REG:
+      netlist.setVertexDstReg(getVertexID(op.src));
+      break;
+    case GraphOp::Kind::APPLY_VAR_OPS:
+      applyVarOps(op.src);
+      break;
+    }
+  };
+  for (auto &partition : partitions) {
+    localVertexIDs.clear();
+    for (std::size_t i = partition.begin; i < partition.end; i++) {
+      applyVarOps(statementItems[i].varOpsBefore);
+      auto opsBegin = partition.itemOpStarts[i - partition.begin];
+      auto opsEnd = i + 1 < partition.end ?
+                      partition.itemOpStarts[i + 1 - partition.begin] :
+                      partition.ops.size();
+      for (auto j = opsBegin; j < opsEnd; j++) {
+        applyOp(partition.ops[j]);
+      }
+    }
+  }
+  applyVarOps(varOps.size());
+  for (auto &varDTypeID : varDTypeIDs) {
+    varDTypeID.first = varVertexIDs[varDTypeID.first & ~VAR_SLOT_TAG];
+  }
+  BOOST_LOG_TRIVIAL(info) << boost::format("Built graph from %d statements with %d threads")
+                               % statementItems.size() % numPartitions;
+}
+
 std::size_t ReadVerilatorXML::numChildren(XMLNode *node) {
   std::size_t count = 0;
   for (XMLNode *child = node->first_node();
@@ -140,14 +293,29 @@ void ReadVerilatorXML::iterateChildren(XMLNode *node) {
 }
 
 void ReadVerilatorXML::newScope(XMLNode *node) {
+  beginScope(node);
+  iterateChildren(node);
+  endScope();
+}
+
+void ReadVerilatorXML::beginScope(XMLNode *node) {
   BOOST_LOG_TRIVIAL(debug) << "New scope";
   scopeParents.push(std::move(currentScope));
   currentScope = std::make_unique<ScopeNode>(node);
-  iterateChildren(node);
+}
+
+void ReadVerilatorXML::endScope() {
   currentScope = std::move(scopeParents.top());
   scopeParents.pop();
 }
 
+void ReadVerilatorXML::newFile(XMLNode *node) {
+  auto fileId = node->first_attribute("id")->value();
+  auto filename = node->first_attribute("filename")->value();
+  auto language = node->first_attribute("language")->value();
+  fileIndexSlot(fileId) = addFile(File(filename, language));
+}
+
 /// Canonicalise a name by adding the top prefix '<module_name>.' if it is not
 /// already a prefix. This is used for associating variable declarations with
 /// references.
@@ -166,39 +334,105 @@ std::string ReadVerilatorXML::removeTopPrefix(std::string name) {
   return name;
 }
 
-VertexID ReadVerilatorXML::lookupVarVertexExact(const std::string &name) {
+VertexID ReadVerilatorXML::lookupVarVertexExact(std::string_view name) {
   // Lookup the vertex name directly.
-  if (vars.count(name)) {
-    return vars[name];
+  auto vertex = tables->vars.find(name);
+  if (vertex && isVarVisible(*vertex)) {
+    return *vertex;
   }
   // Not found.
   return netlist.nullVertex();
 }
 
-VertexID ReadVerilatorXML::lookupVarVertex(const std::string &name) {
+VertexID ReadVerilatorXML::lookupVarVertex(std::string_view name) {
   // Lookup the vertex name directly.
-  if (vars.count(name)) {
-    return vars[name];
+  auto vertex = tables->vars.find(name);
+  if (vertex && isVarVisible(*vertex)) {
+    return *vertex;
   }
-  // Try to add the top suffix.
-  auto extendedName = addTopPrefix(name);
-  if (vars.count(extendedName)) {
-    return vars[extendedName];
+  // Try to add the top prefix (as addTopPrefix), without creating the name.
+  auto visibleTopName = getVisibleTopName();
+  if (!visibleTopName.empty() &&
+      name.rfind(visibleTopName, 0) == std::string_view::npos) {
+    vertex = tables->vars.find(visibleTopName, ".", name);
+    if (vertex && isVarVisible(*vertex)) {
+      return *vertex;
+    }
   }
   // Not found.
   return netlist.nullVertex();
 }
 
-Location ReadVerilatorXML::parseLocation(const std::string location) {
-  std::vector<std::string> tokens;
-  boost::split(tokens, location, boost::is_any_of(","));
-  auto fileId    = tokens[0];
-  auto file      = fileIdMappings[fileId];
-  auto startLine = static_cast<unsigned>(std::stoul(tokens[1]));
-  auto endLine   = static_cast<unsigned>(std::stoul(tokens[3]));
-  auto startCol  = static_cast<unsigned>(std::stoul(tokens[2]));
-  auto endCol    = static_cast<unsigned>(std::stoul(tokens[4]));
-  return Location(file, startLine, startCol, endLine, endCol);
+/// Verilator identifies files with short lower-case letter sequences ('a',
+/// 'b', ..., 'z', 'ba', ...). Decode such an identifier as a bijective base-26
+/// number to give a dense index, or return zero for any other identifier.
+static std::size_t decodeFileId(std::string_view fileId) {
+  constexpr std::size_t MAX_LETTERS = 4;
+  if (fileId.empty() || fileId.size() > MAX_LETTERS) {
+    return 0;
+  }
+  std::size_t value = 0;
+  for (char c : fileId) {
+    if (c < 'a' || c > 'z') {
+      return 0;
+    }
+    value = (value * 26) + static_cast<std::size_t>(c - 'a') + 1;
+  }
+  return value;
+}
+
+/// Return a reference to the file index entry for a file identifier, creating
+/// an unknown entry if it does not exist.
+uint32_t &ReadVerilatorXML::fileIndexSlot(std::string_view fileId) {
+  auto value = decodeFileId(fileId);
+  if (value == 0) {
+    return otherFileIndices.emplace(std::string(fileId),
+                                    Location::NULL_INDEX).first->second;
+  }
+  if (value >= fileIndices.size()) {
+    fileIndices.resize(value + 1, Location::NULL_INDEX);
+  }
+  return fileIndices[value];
+}
+
+uint32_t ReadVerilatorXML::lookupFileIndex(std::string_view fileId) {
+  auto value = decodeFileId(fileId);
+  if (value == 0) {
+    auto it = tables->otherFileIndices.find(std::string(fileId));
+    return it != tables->otherFileIndices.end() ? it->second : Location::NULL_INDEX;
+  }
+  return value < tables->fileIndices.size() ? tables->fileIndices[value]
+                                            : Location::NULL_INDEX;
+}
+
+/// Parse the 'loc' attribute of a node, which has the form
+/// '<file id>,<start line>,<start col>,<end line>,<end col>', directly from
+/// the attribute value without intermediate strings.
+Location ReadVerilatorXML::parseLocation(XMLNode *node) {
+  auto attr = node->first_attribute("loc");
+  if (!attr) {
+    throw XMLException(std::string("missing location for ")+node->name());
+  }
+  const char *begin = attr->value();
+  const char *end = begin + attr->value_size();
+  const char *pos = std::find(begin, end, ',');
+  auto fileIndex = lookupFileIndex(std::string_view(begin, pos - begin));
+  unsigned values[4];
+  for (auto &value : values) {
+    if (pos == end) {
+      throw XMLException(std::string("malformed location ")+attr->value());
+    }
+    auto result = std::from_chars(pos + 1, end, value);
+    if (result.ec != std::errc()) {
+      throw XMLException(std::string("malformed location ")+attr->value());
+    }
+    pos = result.ptr;
+  }
+  auto startLine = values[0];
+  auto startCol  = values[1];
+  auto endLine   = values[2];
+  auto endCol    = values[3];
+  return Location(fileIndex, startLine, startCol, endLine, endCol);
 }
 
 void ReadVerilatorXML::newVar(XMLNode *node) {
@@ -207,8 +441,8 @@ void ReadVerilatorXML::newVar(XMLNode *node) {
   // followed by a <topscope>, <scope> and then <varscopes>. There is no other
   // scoping in the netlist.
   auto name = std::string(node->first_attribute("name")->value());
-  auto location = parseLocation(node->first_attribute("loc")->value());
-  auto dtypeID = node->first_attribute("dtype_id")->value();
+  auto location = parseLocation(node);
+  auto dtypeID = parseDTypeID(node->first_attribute("dtype_id")->value());
   auto direction = (node->first_attribute("dir")) ?
                      getVertexDirection(node->first_attribute("dir")->value()) :
                      VertexDirection::NONE;
@@ -232,6 +466,7 @@ void ReadVerilatorXML::newVar(XMLNode *node) {
         name.rfind("__V", 0) == std::string::npos) {
       if (topName.empty()) {
         topName = name.substr(0, pos);
+        topNameSlot = varVertices.size();
         BOOST_LOG_TRIVIAL(debug) << "Got top name " << topName;
       } else {
         assert(topName == name.substr(0, pos) && "all name prefixes should match the top name");
@@ -240,12 +475,13 @@ void ReadVerilatorXML::newVar(XMLNode *node) {
   }
 
   // Canonicalise the variable name by adding a top prefix if it is known.
+  // The data type is resolved once the type table has been read, since it may
+  // appear after the variable in the netlist.
   auto canonicalName = addTopPrefix(name);
-  auto vertex = netlist.addVarVertex(VertexAstType::VAR, direction, location,
-                                     dtypeMappings[dtypeID], canonicalName,
-                                     isParam, paramValue, isPublic);
-  if (vars.count(canonicalName) == 0) {
-    vars[canonicalName] = vertex;
+  auto vertex = addVarVertex(direction, location, canonicalName,
+                             isParam, paramValue, isPublic);
+  varDTypeIDs.emplace_back(vertex, dtypeID);
+  if (vars.insert(canonicalName, vertex)) {
     BOOST_LOG_TRIVIAL(debug) << boost::format("Add var %s (canonical %s) to scope") % name % canonicalName;
   } else {
     BOOST_LOG_TRIVIAL(debug) << boost::format("Var %s (canonical %s) already exists") % name % canonicalName;
@@ -259,16 +495,16 @@ void ReadVerilatorXML::newVar(XMLNode *node) {
     auto publicVertex = lookupVarVertexExact(origName);
     if (publicVertex != netlist.nullVertex() &&
         publicVertex != vertex &&
-        netlist.getVertex(publicVertex).isPort() &&
+        getVertex(publicVertex).isPort() &&
         !isParam) {
-      netlist.addEdge(publicVertex, vertex);
-      netlist.addEdge(vertex, publicVertex);
+      addEdge(publicVertex, vertex);
+      addEdge(vertex, publicVertex);
       // The direction attribute is only on the top-level/public var, so copy it
       // onto the prefixed version so that they are both identified as ports.
-      netlist.setVertexDirection(vertex, netlist.getVertex(publicVertex).getDirection());
+      setVertexDirection(vertex, getVertex(publicVertex).getDirection());
       BOOST_LOG_TRIVIAL(debug) << "Edge to/from original var "
-                               << netlist.getVertex(publicVertex).toString() << " to "
-                               << netlist.getVertex(vertex).toString();
+                               << getVertex(publicVertex).toString() << " to "
+                               << getVertex(vertex).toString();
     }
   }
 }
@@ -286,16 +522,24 @@ void ReadVerilatorXML::newVarScope(XMLNode *node) {
 void ReadVerilatorXML::newStatement(XMLNode *node, VertexAstType vertexType) {
   BOOST_LOG_TRIVIAL(debug) << "New statement: " << getVertexAstTypeStr(vertexType);
   // A statment must have a scope for variable references to occur in.
-  if (currentScope) {
+  if (currentScope && mode == BuildMode::VARS) {
+    // Record a top-level statement to be elaborated later, and read only its
+    // variables.
+    statementItems.push_back(StatementItem{node,
+                                           varElementMarks.size(),
+                                           varVertices.size(),
+                                           varOps.size()});
+    visitVarElements(node);
+  } else if (currentScope) {
     logicParents.push(std::move(currentLogic));
     // Create a vertex for this logic.
-    auto location = parseLocation(node->first_attribute("loc")->value());
-    auto vertex = netlist.addLogicVertex(vertexType, location);
+    auto location = parseLocation(node);
+    auto vertex = addLogicVertex(vertexType, location);
     currentLogic = std::make_unique<LogicNode>(node, *currentScope, vertex);
     // Create an edge from the parent logic to this one.
     if (logicParents.top()) {
       auto vertexParent = logicParents.top()->getVertex();
-      netlist.addEdge(vertexParent, vertex);
+      addEdge(vertexParent, vertex);
       BOOST_LOG_TRIVIAL(debug) << "Edge from parent logic to "
                                << getVertexAstTypeStr(vertexType);
     }
@@ -319,7 +563,14 @@ void ReadVerilatorXML::newStatement(XMLNode *node, VertexAstType vertexType) {
 }
 
 void ReadVerilatorXML::newVarRef(XMLNode *node) {
-  if (currentScope) {
+  if (currentScope && mode == BuildMode::VARS) {
+    // A reference outside a statement is an error, which is reported when it
+    // is elaborated so that errors are reported in document order.
+    statementItems.push_back(StatementItem{node,
+                                           varElementMarks.size(),
+                                           varVertices.size(),
+                                           varOps.size()});
+  } else if (currentScope) {
     if (!currentLogic) {
       auto name = std::string(node->first_attribute("name")->value());
       throw XMLException(std::string("var ")+name+" not under a logic block");
@@ -333,17 +584,17 @@ void ReadVerilatorXML::newVarRef(XMLNode *node) {
       // Assignment to var
       if (isDelayedAssign) {
         // Var is reg l-value.
-        netlist.addEdge(currentLogic->getVertex(), varVertex);
-        netlist.setVertexDstReg(varVertex);
+        addEdge(currentLogic->getVertex(), varVertex);
+        setVertexDstReg(varVertex);
         BOOST_LOG_TRIVIAL(debug) << "Edge from LOGIC to REG " << varName;
       } else {
         // Var is wire l-value.
-        netlist.addEdge(currentLogic->getVertex(), varVertex);
+        addEdge(currentLogic->getVertex(), varVertex);
         BOOST_LOG_TRIVIAL(debug) << "Edge from LOGIC to VAR " << varName;
       }
     } else {
       // Var is wire r-value.
-      netlist.addEdge(varVertex, currentLogic->getVertex());
+      addEdge(varVertex, currentLogic->getVertex());
       BOOST_LOG_TRIVIAL(debug) << "Edge from VAR " << varName << " to LOGIC";
     }
     iterateChildren(node);
@@ -409,11 +660,21 @@ void ReadVerilatorXML::visitCFunc(XMLNode *node) {
 }
 
 void ReadVerilatorXML::visitVar(XMLNode *node) {
-  newVar(node);
+  if (mode == BuildMode::STATEMENTS) {
+    applyVarElement();
+  } else {
+    newVar(node);
+    recordVarElement();
+  }
 }
 
 void ReadVerilatorXML::visitVarScope(XMLNode *node) {
-  newVarScope(node);
+  if (mode == BuildMode::STATEMENTS) {
+    applyVarElement();
+  } else {
+    newVarScope(node);
+    recordVarElement();
+  }
 }
 
 void ReadVerilatorXML::visitVarRef(XMLNode *node) {
@@ -435,46 +696,44 @@ void ReadVerilatorXML::visitTypedef(XMLNode *node) {
 }
 
 void ReadVerilatorXML::visitBasicDtype(XMLNode *node) {
-  auto id = node->first_attribute("id")->value();
-  if (dtypeMappings.count(id) == 0) {
+  if (mode == BuildMode::STATEMENTS) {
+    return; // Read by the variable pass.
+  }
+  auto id = parseDTypeID(node->first_attribute("id")->value());
+  if (!lookupDType(id)) {
     auto name = node->first_attribute("name")->value();
-    auto location = parseLocation(node->first_attribute("loc")->value());
+    auto location = parseLocation(node);
     if (node->first_attribute("left") && node->first_attribute("right")) {
       auto left = std::stoul(node->first_attribute("left")->value());
       auto right = std::stoul(node->first_attribute("right")->value());
-      dtypeMappings[id] = std::make_shared<BasicDType>(name, location, left, right);
+      addDTypeMapping(id, std::make_shared<BasicDType>(name, location, left, right));
     } else {
-      dtypeMappings[id] = std::make_shared<BasicDType>(name, location);
+      addDTypeMapping(id, std::make_shared<BasicDType>(name, location));
     }
-    addDtype(dtypeMappings[id]);
   }
 }
 
 void ReadVerilatorXML::visitRefDtype(XMLNode *node) {
-  auto id = node->first_attribute("id")->value();
-  auto subDTypeId = node->first_attribute("sub_dtype_id")->value();
-  if (dtypeMappings.count(id) == 0) {
+  if (mode == BuildMode::STATEMENTS) {
+    return; // Read by the variable pass.
+  }
+  auto id = parseDTypeID(node->first_attribute("id")->value());
+  auto subDTypeId = parseDTypeID(node->first_attribute("sub_dtype_id")->value());
+  if (!lookupDType(id)) {
     auto name = node->first_attribute("name")->value();
-    auto location = parseLocation(node->first_attribute("loc")->value());
-    dtypeMappings[id] = std::make_shared<RefDType>(name, location);
-    addDtype(dtypeMappings[id]);
-  } else {
-    // Second pass (sub DType declaration can occur after).
-    if (dtypeMappings.count(subDTypeId) == 0) {
-      throw XMLException(std::string("could not find ref sub dtype ID ")+subDTypeId);
-    }
-    dynamic_cast<RefDType*>(dtypeMappings[id].get())->setSubDType(dtypeMappings[subDTypeId]);
+    auto location = parseLocation(node);
+    addDTypeMapping(id, std::make_shared<RefDType>(name, location));
   }
+  // The sub DType declaration can occur after.
+  dtypeFixups.push_back(DTypeFixup{DTypeFixup::Kind::REF, id, subDTypeId});
 }
 
-MemberDType ReadVerilatorXML::visitMemberDType(XMLNode *node) {
-  auto name = node->first_attribute("name")->value();
-  auto location = parseLocation(node->first_attribute("loc")->value());
-  auto subDTypeId = node->first_attribute("sub_dtype_id")->value();
-  if (dtypeMappings.count(subDTypeId) == 0) {
-    throw XMLException(std::string("could not find member sub dtype ID ")+subDTypeId);
-  }
-  return MemberDType(name, location, dtypeMappings[subDTypeId]);
+void ReadVerilatorXML::visitMemberDType(XMLNode *node, std::size_t parentId) {
+  auto subDTypeId = parseDTypeID(node->first_attribute("sub_dtype_id")->value());
+  // Members are created once the sub DType is known.
+  dtypeFixups.push_back(DTypeFixup{DTypeFixup::Kind::MEMBER, parentId, subDTypeId,
+                                   node->first_attribute("name")->value(),
+                                   parseLocation(node)});
 }
 
 size_t ReadVerilatorXML::visitConst(XMLNode *node) {
@@ -503,32 +762,33 @@ ReadVerilatorXML::visitRange(XMLNode *node) {
 }
 
 void ReadVerilatorXML::visitArrayDType(XMLNode *node, bool packed) {
-  auto id = node->first_attribute("id")->value();
-  auto subDTypeId = node->first_attribute("sub_dtype_id")->value();
-  if (dtypeMappings.count(id) == 0) {
-    auto location = parseLocation(node->first_attribute("loc")->value());
+  if (mode == BuildMode::STATEMENTS) {
+    return; // Read by the variable pass.
+  }
+  auto id = parseDTypeID(node->first_attribute("id")->value());
+  auto subDTypeId = parseDTypeID(node->first_attribute("sub_dtype_id")->value());
+  if (!lookupDType(id)) {
+    auto location = parseLocation(node);
     assert(numChildren(node) == 1 && "arraydtype expects one range child");
     auto range = visitRange(node->first_node());
-    dtypeMappings[id] = std::make_shared<ArrayDType>(location,
+    addDTypeMapping(id, std::make_shared<ArrayDType>(location,
                                                      range.first,
                                                      range.second,
-                                                     packed);
-    addDtype(dtypeMappings[id]);
-  } else {
-    // Second pass (sub DType declaration can occur after).
-    if (dtypeMappings.count(subDTypeId) == 0) {
-      throw XMLException(std::string("could not find array sub dtype ID ")+subDTypeId);
-    }
-    dynamic_cast<ArrayDType*>(dtypeMappings[id].get())->setSubDType(dtypeMappings[subDTypeId]);
+                                                     packed));
   }
+  // The sub DType declaration can occur after.
+  dtypeFixups.push_back(DTypeFixup{DTypeFixup::Kind::ARRAY, id, subDTypeId});
 }
 
 /// Shared handling for structs and unions.
 template<typename T>
 void ReadVerilatorXML::visitAggregateDType(XMLNode *node) {
-  auto id = node->first_attribute("id")->value();
-  if (dtypeMappings.count(id) == 0) {
-    auto location = parseLocation(node->first_attribute("loc")->value());
+  if (mode == BuildMode::STATEMENTS) {
+    return; // Read by the variable pass.
+  }
+  auto id = parseDTypeID(node->first_attribute("id")->value());
+  if (!lookupDType(id)) {
+    auto location = parseLocation(node);
     std::shared_ptr<T> dtype;
     // Struct or union may not be named, and defined inline with a declaration.
     if (node->first_attribute("name")) {
@@ -537,16 +797,13 @@ void ReadVerilatorXML::visitAggregateDType(XMLNode *node) {
     } else {
       dtype = std::make_shared<T>(location);
     }
-    dtypeMappings[id] = dtype;
-    addDtype(dtype);
-  } else {
-    // Second pass to resolve sub DTypes.
-    for (XMLNode *child = node->first_node();
-         child; child = child->next_sibling()) {
-      assert(std::string(child->name()) == "memberdtype" &&
-             "aggregate dtype expects memberdtype children");
-      dynamic_cast<T*>(dtypeMappings[id].get())->addMemberDType(visitMemberDType(child));
-    }
+    addDTypeMapping(id, dtype);
+  }
+  for (XMLNode *child = node->first_node();
+       child; child = child->next_sibling()) {
+    assert(std::string(child->name()) == "memberdtype" &&
+           "aggregate dtype expects memberdtype children");
+    visitMemberDType(child, id);
   }
 }
 
@@ -557,10 +814,13 @@ EnumItem ReadVerilatorXML::visitEnumItem(XMLNode *node) {
 }
 
 void ReadVerilatorXML::visitEnumDType(XMLNode *node) {
-  auto id = node->first_attribute("id")->value();
-  auto subDTypeId = node->first_attribute("sub_dtype_id")->value();
-  if (dtypeMappings.count(id) == 0) {
-    auto location = parseLocation(node->first_attribute("loc")->value());
+  if (mode == BuildMode::STATEMENTS) {
+    return; // Read by the variable pass.
+  }
+  auto id = parseDTypeID(node->first_attribute("id")->value());
+  auto subDTypeId = parseDTypeID(node->first_attribute("sub_dtype_id")->value());
+  if (!lookupDType(id)) {
+    auto location = parseLocation(node);
     auto name = node->first_attribute("name")->value();
     auto dtype = std::make_shared<EnumDType>(name, location);
     for (XMLNode *child = node->first_node();
@@ -569,43 +829,114 @@ void ReadVerilatorXML::visitEnumDType(XMLNode *node) {
              "enumdtype expects enumitem children");
       dtype->addItem(visitEnumItem(child));
     }
-    dtypeMappings[id] = dtype;
-    addDtype(dtype);
-  } else {
-    // Second pass (sub DType declaration can occur after).
-    if (dtypeMappings.count(subDTypeId) == 0) {
-      throw XMLException(std::string("could not find enum sub dtype ID ")+subDTypeId);
-    }
-    dynamic_cast<EnumDType*>(dtypeMappings[id].get())->setSubDType(dtypeMappings[subDTypeId]);
+    addDTypeMapping(id, dtype);
   }
+  // The sub DType declaration can occur after.
+  dtypeFixups.push_back(DTypeFixup{DTypeFixup::Kind::ENUM, id, subDTypeId});
 }
 
 void ReadVerilatorXML::visitInterfaceRefDType(XMLNode *node) {
  // To do.
 }
 
+std::size_t ReadVerilatorXML::parseDTypeID(const char *value) {
+  std::size_t id;
+  auto end = value + std::strlen(value);
+  auto result = std::from_chars(value, end, id);
+  if (result.ec != std::errc() || result.ptr != end) {
+    throw XMLException(std::string("invalid dtype ID ")+value);
+  }
+  return id;
+}
+
+std::shared_ptr<DType> ReadVerilatorXML::lookupDType(std::size_t id) const {
+  return id < dtypeMappings.size() ? dtypeMappings[id] : nullptr;
+}
+
+void ReadVerilatorXML::addDTypeMapping(std::size_t id,
+                                       std::shared_ptr<DType> dtype) {
+  if (id >= dtypeMappings.size()) {
+    dtypeMappings.resize(id + 1);
+  }
+  dtypeMappings[id] = dtype;
+  addDtype(dtype);
+}
+
+/// Patch the sub dtype references in the type table, in the order they were
+/// read.
+void ReadVerilatorXML::resolveDTypeFixups() {
+  for (auto &fixup : dtypeFixups) {
+    auto subDType = lookupDType(fixup.subDTypeId);
+    auto dtype = dtypeMappings[fixup.id].get();
+    switch (fixup.kind) {
+    case DTypeFixup::Kind::REF:
+      if (!subDType) {
+        throw XMLException(std::string("could not find ref sub dtype ID ")+
+                           std::to_string(fixup.subDTypeId));
+      }
+      dynamic_cast<RefDType*>(dtype)->setSubDType(subDType);
+      break;
+    case DTypeFixup::Kind::ARRAY:
+      if (!subDType) {
+        throw XMLException(std::string("could not find array sub dtype ID ")+
+                           std::to_string(fixup.subDTypeId));
+      }
+      dynamic_cast<ArrayDType*>(dtype)->setSubDType(subDType);
+      break;
+    case DTypeFixup::Kind::ENUM:
+      if (!subDType) {
+        throw XMLException(std::string("could not find enum sub dtype ID ")+
+                           std::to_string(fixup.subDTypeId));
+      }
+      dynamic_cast<EnumDType*>(dtype)->setSubDType(subDType);
+      break;
+    case DTypeFixup::Kind::MEMBER: {
+      if (!subDType) {
+        throw XMLException(std::string("could not find member sub dtype ID ")+
+                           std::to_string(fixup.subDTypeId));
+      }
+      auto member = MemberDType(fixup.name, fixup.location, subDType);
+      if (auto structDType = dynamic_cast<StructDType*>(dtype)) {
+        structDType->addMemberDType(member);
+      } else {
+        dynamic_cast<UnionDType*>(dtype)->addMemberDType(member);
+      }
+      break;
+    }
+    }
+  }
+  dtypeFixups.clear();
+}
+
+void ReadVerilatorXML::readTypeTable(XMLNode *node) {
+  // A single pass, with forward dtype ID references resolved afterwards.
+  visitTypeTable(node);
+  resolveDTypeFixups();
+  BOOST_LOG_TRIVIAL(info) << boost::format("%d entries in type table") % dtypes.size();
+}
+
+void ReadVerilatorXML::resolveVarDTypes() {
+  for (auto &varDTypeID : varDTypeIDs) {
+    if (auto dtype = lookupDType(varDTypeID.second)) {
+      netlist.setVertexDType(varDTypeID.first, dtype);
+    }
+  }
+  varDTypeIDs.clear();
+}
+
 void ReadVerilatorXML::readXML(const std::string &filename) {
   BOOST_LOG_TRIVIAL(info) << "Parsing input XML file";
-  std::fstream inputFile(filename);
-  if (!inputFile.is_open()) {
-    throw XMLException("could not open file");
-  }
-  // Parse the buffered XML.
+  // Map the file into memory and parse the XML in situ.
+  MappedFile inputFile(filename);
   rapidxml::xml_document<> doc;
-  std::vector<char> buffer((std::istreambuf_iterator<char>(inputFile)),
-                            std::istreambuf_iterator<char>());
-  buffer.push_back('\0');
-  doc.parse<0>(&buffer[0]);
+  doc.parse<0>(inputFile.getData());
   // Find our root node
   XMLNode *rootNode = doc.first_node("verilator_xml");
   // Files section
   XMLNode *filesNode = rootNode->first_node("files");
   for (XMLNode *fileNode = filesNode->first_node("file");
        fileNode; fileNode = fileNode->next_sibling()) {
-    auto fileId = fileNode->first_attribute("id")->value();
-    auto filename = fileNode->first_attribute("filename")->value();
-    auto language = fileNode->first_attribute("language")->value();
-    fileIdMappings[fileId] = addFile(File(filename, language));
+    newFile(fileNode);
   }
   // Netlist section.
   XMLNode *netlistNode = rootNode->first_node("netlist");
@@ -622,15 +953,20 @@ void ReadVerilatorXML::readXML(const std::string &filename) {
   BOOST_LOG_TRIVIAL(info) << moduleCount    << " modules in netlist";
   BOOST_LOG_TRIVIAL(info) << interfaceCount << " interfaces in netlist";
   BOOST_LOG_TRIVIAL(info) << packageCount   << " packages in netlist";
-  // Typetable (two passes to resolve forward dtype ID references).
-  XMLNode *typeTableNode = netlistNode->first_node("typetable");
-  visitTypeTable(typeTableNode);
-  visitTypeTable(typeTableNode);
-  BOOST_LOG_TRIVIAL(info) << boost::format("%d entries in type table") % dtypes.size();
+  // Typetable.
+  readTypeTable(netlistNode->first_node("typetable"));
   // Module (single instance).
   if (moduleCount == 1 && interfaceCount == 0) {
     XMLNode *topModuleNode = netlistNode->first_node("module");
-    visitModule(topModuleNode);
+    auto numJobs = Options::getInstance().getNumJobs();
+    if (numJobs > 1) {
+      visitModuleParallel(topModuleNode, numJobs);
+    } else {
+      visitModule(topModuleNode);
+    }
+    // Resolve the data types declared within statements.
+    resolveDTypeFixups();
+    resolveVarDTypes();
     if (std::string(topModuleNode->first_attribute("name")->value()) != "TOP") {
       throw XMLException("unexpected top module name");
     }
@@ -641,6 +977,101 @@ void ReadVerilatorXML::readXML(const std::string &filename) {
   }
 }
 
+/// Read the netlist from a stream of XML elements, so that only one top-level
+/// file, variable, statement or type table is held as a document tree at any
+/// time. Since the module count is only known at the end of the stream, the
+/// first module is read as it arrives and the graph is discarded if the
+/// netlist turns out not to be flat.
+void ReadVerilatorXML::readXMLStream(const std::string &filename) {
+  BOOST_LOG_TRIVIAL(info) << "Streaming input XML file";
+  if (Options::getInstance().getNumJobs() > 1) {
+    // A parallel build elaborates statements from a document tree of the
+    // whole module, which streaming avoids building.
+    BOOST_LOG_TRIVIAL(warning) << "Streamed netlists are read by a single thread";
+  }
+  XMLStream stream(filename);
+  auto isContainer = [](const std::string &name) {
+    return name == "verilator_xml" ||
+           name == "files" ||
+           name == "netlist" ||
+           name == "module" ||
+           name == "iface" ||
+           name == "package" ||
+           name == "topscope" ||
+           name == "scope";
+  };
+  std::vector<std::string> parents;
+  size_t moduleCount = 0;
+  size_t interfaceCount = 0;
+  size_t packageCount = 0;
+  bool readTopModule = false;
+  bool inTopModule = false;
+  while (true) {
+    auto event = stream.next(isContainer);
+    if (event == XMLStream::Event::END) {
+      break;
+    }
+    const auto &name = stream.getName();
+    switch (event) {
+    case XMLStream::Event::OPEN:
+      if (name == "module" || name == "iface" || name == "package") {
+        if (name == "iface") { interfaceCount++; }
+        if (name == "module") { moduleCount++; }
+        if (name == "package") { packageCount++; }
+        // Only the first module is read, and only if it is the top module.
+        if (moduleCount == 1 && name == "module" &&
+            std::string(stream.getNode()->first_attribute("name")->value()) == "TOP") {
+          readTopModule = true;
+          inTopModule = true;
+        } else {
+          stream.skip();
+          continue;
+        }
+      } else if (inTopModule && (name == "topscope" || name == "scope")) {
+        // The start tag does not outlive the event, so it is not recorded.
+        beginScope(nullptr);
+      }
+      parents.push_back(name);
+      break;
+    case XMLStream::Event::CLOSE:
+      if (name == "module") {
+        inTopModule = false;
+      } else if (inTopModule && (name == "topscope" || name == "scope")) {
+        endScope();
+      }
+      parents.pop_back();
+      break;
+    case XMLStream::Event::ELEMENT:
+      if (inTopModule) {
+        dispatchVisitor(stream.getNode());
+      } else if (!parents.empty() && parents.back() == "files" && name == "file") {
+        newFile(stream.getNode());
+      } else if (name == "typetable") {
+        readTypeTable(stream.getNode());
+      }
+      break;
+    default:
+      break;
+    }
+  }
+  BOOST_LOG_TRIVIAL(info) << moduleCount    << " modules in netlist";
+  BOOST_LOG_TRIVIAL(info) << interfaceCount << " interfaces in netlist";
+  BOOST_LOG_TRIVIAL(info) << packageCount   << " packages in netlist";
+  if (moduleCount == 1 && interfaceCount == 0) {
+    if (!readTopModule) {
+      throw XMLException("unexpected top module name");
+    }
+    // Resolve the data types declared within statements.
+    resolveDTypeFixups();
+    resolveVarDTypes();
+    BOOST_LOG_TRIVIAL(info) << boost::format("Netlist contains %d vertices and %d edges")
+                                 % netlist.numVertices() % netlist.numEdges();
+  } else {
+    netlist.clear();
+    BOOST_LOG_TRIVIAL(info) << "Netlist is not flat, skipping modules";
+  }
+}
+
 ReadVerilatorXML::ReadVerilatorXML(Graph &netlist,
                                    std::vector<File> &files,
                                    std::vector<std::shared_ptr<DType>> &dtypes,
@@ -651,6 +1082,36 @@ ReadVerilatorXML::ReadVerilatorXML(Graph &netlist,
     currentLogic(nullptr),
     currentScope(nullptr),
     isDelayedAssign(false),
-    isLValue(false) {
-  readXML(filename);
+    isLValue(false),
+    tables(this),
+    mode(BuildMode::DIRECT),
+    ops(nullptr),
+    topNameSlot(0),
+    varElementIndex(0),
+    visibleVarSlots(0),
+    numLocalVertices(0) {
+  if (Options::getInstance().shouldStreamXML()) {
+    readXMLStream(filename);
+  } else {
+    readXML(filename);
+  }
 }
+
+/// Construct a reader to elaborate statements in a separate thread, using the
+/// variables and files of a parent reader.
+ReadVerilatorXML::ReadVerilatorXML(const ReadVerilatorXML &parent,
+                                   std::vector<GraphOp> &ops) :
+    netlist(parent.netlist),
+    files(parent.files),
+    dtypes(parent.dtypes),
+    currentLogic(nullptr),
+    currentScope(std::make_unique<ScopeNode>(nullptr)),
+    isDelayedAssign(false),
+    isLValue(false),
+    tables(&parent),
+    mode(BuildMode::STATEMENTS),
+    ops(&ops),
+    topNameSlot(0),
+    varElementIndex(0),
+    visibleVarSlots(0),
+    numLocalVertices(0) {}
@@ -2,14 +2,17 @@
 #define NETLIST_PATHS_READ_VERILATOR_XML_HPP
 
 #include <algorithm>
+#include <limits>
 #include <memory>
 #include <stack>
+#include <string_view>
 #include <vector>
 #include <utility>
 #include <boost/algorithm/string/predicate.hpp>
 #include <rapidxml-1.13/rapidxml.hpp>
 
 #include "netlist_paths/Graph.hpp"
+#include "netlist_paths/VarTable.hpp"
 
 namespace netlist_paths {
 
@@ -44,14 +47,68 @@ public:
   VertexID getVertex() { return vertex; }
 };
 
+/// A reference from a dtype to a sub dtype. Since the sub dtype can be declared
+/// later in the type table, references are resolved once the whole table has
+/// been read.
+struct DTypeFixup {
+  enum class Kind { REF, ARRAY, ENUM, MEMBER };
+  Kind kind;
+  std::size_t id;
+  std::size_t subDTypeId;
+  std::string name;  // Member name.
+  Location location; // Member location.
+};
+
+/// A graph construction operation, recorded while the graph is being built by
+/// several threads and applied to the graph afterwards. Vertices are
+/// identified by IDs local to the recording thread, or by a variable slot
+/// (tagged with VAR_SLOT_TAG).
+struct GraphOp {
+  enum class Kind {
+    ADD_VAR_VERTEX,   ///< Add the variable vertex in slot src.
+    ADD_LOGIC_VERTEX, ///< Add a logic vertex with the next local ID.
+    ADD_EDGE,         ///< Add an edge from src to dst.
+    SET_DST_REG,      ///< Set src to be a destination register.
+    APPLY_VAR_OPS     ///< Apply variable operations up to index src.
+  };
+  Kind kind;
+  VertexAstType astType;
+  Location location;
+  VertexID src;
+  VertexID dst;
+};
+
+/// A top-level statement of a scope, which can be elaborated independently of
+/// other statements once all variables have been read.
+struct StatementItem {
+  XMLNode *node;
+  std::size_t varElementIndex; ///< The number of var elements preceding it.
+  std::size_t visibleVarSlots; ///< The number of variables declared before it.
+  std::size_t varOpsBefore;    ///< The number of var operations preceding it.
+};
+
+/// The ways that the graph can be constructed.
+enum class BuildMode {
+  DIRECT,    ///< Directly, in a single thread.
+  VARS,      ///< Read only variables, and record statements to elaborate later.
+  STATEMENTS ///< Read only statements, recording graph operations.
+};
+
+/// Tag identifying a variable slot rather than a vertex in a GraphOp.
+constexpr VertexID VAR_SLOT_TAG =
+    VertexID(1) << (std::numeric_limits<VertexID>::digits - 1);
+
 class ReadVerilatorXML {
 private:
   Graph &netlist;
   std::vector<File> &files;
   std::vector<std::shared_ptr<DType>> &dtypes;
-  std::map<std::string, VertexID> vars;
-  std::map<std::string, std::shared_ptr<File>> fileIdMappings;
-  std::map<std::string, std::shared_ptr<DType>> dtypeMappings;
+  VarTable vars;
+  std::vector<uint32_t> fileIndices;
+  std::map<std::string, uint32_t> otherFileIndices;
+  std::vector<std::shared_ptr<DType>> dtypeMappings;
+  std::vector<DTypeFixup> dtypeFixups;
+  std::vector<std::pair<VertexID, std::size_t>> varDTypeIDs;
   std::stack<std::unique_ptr<LogicNode>> logicParents;
   std::stack<std::unique_ptr<ScopeNode>> scopeParents;
   std::unique_ptr<LogicNode> currentLogic;
@@ -60,23 +117,61 @@ private:
   bool isDelayedAssign;
   bool isLValue;
 
-  std::shared_ptr<File> addFile(File file) {
+  // State for parallel graph construction.
+  const ReadVerilatorXML *tables;
+  BuildMode mode;
+  std::vector<GraphOp> *ops;
+  std::vector<GraphOp> varOps;
+  std::vector<Vertex> varVertices;
+  std::vector<std::pair<std::size_t, std::size_t>> varElementMarks;
+  std::vector<StatementItem> statementItems;
+  std::size_t topNameSlot;
+  std::size_t varElementIndex;
+  std::size_t visibleVarSlots;
+  std::size_t numLocalVertices;
+
+  uint32_t addFile(File file) {
     files.push_back(file);
-    return std::make_shared<File>(files.back());
+    return static_cast<uint32_t>(files.size() - 1);
   }
   void addDtype(std::shared_ptr<DType> dtype) {
     dtypes.push_back(dtype);
   }
+  VertexID addVarVertex(VertexDirection direction,
+                        Location location,
+                        const std::string &name,
+                        bool isParam,
+                        const std::string &paramValue,
+                        bool isPublic);
+  VertexID addLogicVertex(VertexAstType type, Location location);
+  void addEdge(VertexID src, VertexID dst);
+  void setVertexDstReg(VertexID vertex);
+  void setVertexDirection(VertexID vertex, VertexDirection direction);
+  const Vertex &getVertex(VertexID vertex) const;
+  bool isVarVisible(VertexID vertex) const;
+  std::string_view getVisibleTopName() const;
+  void recordVarElement();
+  void applyVarElement();
+  void buildStatements(const StatementItem *begin,
+                       const StatementItem *end,
+                       std::vector<std::size_t> &itemOpStarts);
+  void visitModuleParallel(XMLNode *node, std::size_t numJobs);
   std::size_t numChildren(XMLNode *node);
   void dispatchVisitor(XMLNode *node);
   void iterateChildren(XMLNode *node);
-  Location parseLocation(const std::string location);
+  void visitVarElements(XMLNode *node);
+  uint32_t &fileIndexSlot(std::string_view fileId);
+  uint32_t lookupFileIndex(std::string_view fileId);
+  Location parseLocation(XMLNode *node);
   std::string addTopPrefix(std::string name);
   std::string removeTopPrefix(std::string name);
-  VertexID lookupVarVertexExact(const std::string &name);
-  VertexID lookupVarVertex(const std::string &name);
+  VertexID lookupVarVertexExact(std::string_view name);
+  VertexID lookupVarVertex(std::string_view name);
   void newVar(XMLNode *node);
   void newScope(XMLNode *node);
+  void beginScope(XMLNode *node);
+  void endScope();
+  void newFile(XMLNode *node);
   void newVarScope(XMLNode *node);
   void newStatement(XMLNode *node, VertexAstType);
   void newVarRef(XMLNode *node);
@@ -103,12 +198,21 @@ private:
   void visitInterfaceRefDType(XMLNode *node);
   size_t visitConst(XMLNode *node);
   std::pair<size_t, size_t> visitRange(XMLNode *node);
-  MemberDType visitMemberDType(XMLNode *node);
+  void visitMemberDType(XMLNode *node, std::size_t parentId);
   void visitArrayDType(XMLNode *node, bool packed);
   template<typename T> void visitAggregateDType(XMLNode *node);
   EnumItem visitEnumItem(XMLNode *node);
   void visitEnumDType(XMLNode *node);
+  std::size_t parseDTypeID(const char *value);
+  std::shared_ptr<DType> lookupDType(std::size_t id) const;
+  void addDTypeMapping(std::size_t id, std::shared_ptr<DType> dtype);
+  void resolveDTypeFixups();
+  void readTypeTable(XMLNode *node);
+  void resolveVarDTypes();
   void readXML(const std::string &filename);
+  void readXMLStream(const std::string &filename);
+
+  ReadVerilatorXML(const ReadVerilatorXML &parent, std::vector<GraphOp> &ops);
 
 public:
   ReadVerilatorXML() = delete;
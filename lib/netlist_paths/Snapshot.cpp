@@ -0,0 +1,334 @@
+#include <fstream>
+#include "netlist_paths/Snapshot.hpp"
+
+using namespace netlist_paths;
+
+//===----------------------------------------------------------------------===//
+// SnapshotWriter
+//===----------------------------------------------------------------------===//
+
+void SnapshotWriter::putLocation(const Location &location) {
+  put<uint32_t>(location.getFileIndex());
+  put<uint32_t>(location.getStartLine());
+  put<uint32_t>(location.getStartCol());
+  put<uint32_t>(location.getEndLine());
+  put<uint32_t>(location.getEndCol());
+}
+
+void SnapshotWriter::addDType(const std::shared_ptr<DType> &dtype) {
+  if (!dtype || dtypeIDs.count(dtype.get())) {
+    return;
+  }
+  dtypeIDs.emplace(dtype.get(), static_cast<uint32_t>(dtypeOrder.size()));
+  dtypeOrder.push_back(dtype.get());
+  auto addMembers = [this](const std::vector<MemberDType> &members) {
+    for (auto &member : members) {
+      addDType(member.getSubDType());
+    }
+  };
+  if (auto refDType = dynamic_cast<const RefDType*>(dtype.get())) {
+    addDType(refDType->getSubDType());
+  } else if (auto arrayDType = dynamic_cast<const ArrayDType*>(dtype.get())) {
+    addDType(arrayDType->getSubDType());
+  } else if (auto memberDType = dynamic_cast<const MemberDType*>(dtype.get())) {
+    addDType(memberDType->getSubDType());
+  } else if (auto structDType = dynamic_cast<const StructDType*>(dtype.get())) {
+    addMembers(structDType->getMembers());
+  } else if (auto unionDType = dynamic_cast<const UnionDType*>(dtype.get())) {
+    addMembers(unionDType->getMembers());
+  } else if (auto enumDType = dynamic_cast<const EnumDType*>(dtype.get())) {
+    addDType(enumDType->getSubDType());
+  }
+}
+
+void SnapshotWriter::putDTypes() {
+  auto putMembers = [this](const std::vector<MemberDType> &members) {
+    put<uint64_t>(members.size());
+    for (auto &member : members) {
+      putString(member.getName());
+      putLocation(member.getLocation());
+      putDType(member.getSubDType());
+    }
+  };
+  put<uint64_t>(dtypeOrder.size());
+  for (auto dtype : dtypeOrder) {
+    if (auto basicDType = dynamic_cast<const BasicDType*>(dtype)) {
+      put<SnapshotDType>(SnapshotDType::BASIC);
+      putString(dtype->getName());
+      putLocation(dtype->getLocation());
+      put<uint32_t>(basicDType->getLeft());
+      put<uint32_t>(basicDType->getRight());
+      put<uint8_t>(basicDType->isRanged());
+    } else if (auto refDType = dynamic_cast<const RefDType*>(dtype)) {
+      put<SnapshotDType>(SnapshotDType::REF);
+      putString(dtype->getName());
+      putLocation(dtype->getLocation());
+      putDType(refDType->getSubDType());
+    } else if (auto arrayDType = dynamic_cast<const ArrayDType*>(dtype)) {
+      put<SnapshotDType>(SnapshotDType::ARRAY);
+      putString(dtype->getName());
+      putLocation(dtype->getLocation());
+      put<uint64_t>(arrayDType->getStart());
+      put<uint64_t>(arrayDType->getEnd());
+      put<uint8_t>(arrayDType->isPacked());
+      putDType(arrayDType->getSubDType());
+    } else if (auto memberDType = dynamic_cast<const MemberDType*>(dtype)) {
+      put<SnapshotDType>(SnapshotDType::MEMBER);
+      putString(dtype->getName());
+      putLocation(dtype->getLocation());
+      putDType(memberDType->getSubDType());
+    } else if (auto structDType = dynamic_cast<const StructDType*>(dtype)) {
+      put<SnapshotDType>(SnapshotDType::STRUCT);
+      putString(dtype->getName());
+      putLocation(dtype->getLocation());
+      putMembers(structDType->getMembers());
+    } else if (auto unionDType = dynamic_cast<const UnionDType*>(dtype)) {
+      put<SnapshotDType>(SnapshotDType::UNION);
+      putString(dtype->getName());
+      putLocation(dtype->getLocation());
+      putMembers(unionDType->getMembers());
+    } else if (auto enumDType = dynamic_cast<const EnumDType*>(dtype)) {
+      put<SnapshotDType>(SnapshotDType::ENUM);
+      putString(dtype->getName());
+      putLocation(dtype->getLocation());
+      putDType(enumDType->getSubDType());
+      put<uint64_t>(enumDType->getItems().size());
+      for (auto &item : enumDType->getItems()) {
+        putString(item.getName());
+        put<uint64_t>(item.getValue());
+      }
+    } else {
+      throw Exception(std::string("cannot write data type to snapshot: ")+
+                      dtype->getName());
+    }
+  }
+}
+
+void SnapshotWriter::write(const std::string &filename) const {
+  auto &payload = getPayload();
+  SnapshotHeader header;
+  std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+  header.version = SNAPSHOT_VERSION;
+  header.byteOrder = SNAPSHOT_BYTE_ORDER;
+  header.payloadSize = payload.size();
+  header.checksum = snapshotChecksum(payload.data(), payload.size());
+  std::ofstream outputFile(filename, std::ios::out | std::ios::binary);
+  if (!outputFile.is_open()) {
+    throw Exception(std::string("could not open file ")+filename);
+  }
+  outputFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  outputFile.write(payload.data(), payload.size());
+  if (!outputFile) {
+    throw Exception(std::string("could not write file ")+filename);
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// SnapshotReader
+//===----------------------------------------------------------------------===//
+
+SnapshotReader::SnapshotReader(const std::string &filename) :
+    file(std::make_unique<MappedFile>(filename)), position(file->getData()),
+    end(file->getData() + file->getSize()) {
+  check(sizeof(SnapshotHeader));
+  SnapshotHeader header;
+  std::memcpy(&header, position, sizeof(header));
+  position += sizeof(header);
+  if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0) {
+    throw Exception(filename+" is not a netlist snapshot");
+  }
+  if (header.byteOrder != SNAPSHOT_BYTE_ORDER) {
+    throw Exception(filename+" was written on a machine with a different byte order");
+  }
+  if (header.version != SNAPSHOT_VERSION) {
+    throw Exception((boost::format("%s has snapshot version %d, expected %d")
+                       % filename % header.version % SNAPSHOT_VERSION).str());
+  }
+  if (header.payloadSize != static_cast<uint64_t>(end - position) ||
+      header.checksum != snapshotChecksum(position, end - position)) {
+    throw Exception(std::string("corrupt netlist snapshot ")+filename);
+  }
+}
+
+SnapshotReader::SnapshotReader(const char *data, std::size_t size) :
+    position(data), end(data + size) {}
+
+/// The files of the netlist are read before its data types and vertices, so
+/// the file index of each location is checked against them.
+Location SnapshotReader::getLocation() {
+  auto fileIndex = get<uint32_t>();
+  auto startLine = get<uint32_t>();
+  auto startCol = get<uint32_t>();
+  auto endLine = get<uint32_t>();
+  auto endCol = get<uint32_t>();
+  if (fileIndex != Location::NULL_INDEX && fileIndex >= numFiles) {
+    throw Exception("corrupt netlist snapshot");
+  }
+  return Location(fileIndex, startLine, startCol, endLine, endCol);
+}
+
+std::shared_ptr<DType> SnapshotReader::getDType(uint32_t id) const {
+  if (id == SNAPSHOT_NULL_ID) {
+    return nullptr;
+  }
+  if (id >= dtypes.size()) {
+    throw Exception("corrupt netlist snapshot");
+  }
+  return dtypes[id];
+}
+
+void SnapshotReader::getDTypes() {
+  // Data types can refer to any other data type, so create them all before
+  // resolving references between them.
+  struct Member {
+    std::string name;
+    Location location;
+    uint32_t subDTypeID;
+  };
+  struct References {
+    uint32_t subDTypeID;
+    std::vector<Member> members;
+  };
+  auto numDTypes = getCount();
+  std::vector<References> references(numDTypes);
+  auto getID = [this]() { return get<uint32_t>(); };
+  for (std::size_t i = 0; i < numDTypes; i++) {
+    auto kind = get<SnapshotDType>();
+    auto name = getString();
+    auto location = getLocation();
+    auto &refs = references[i];
+    refs.subDTypeID = SNAPSHOT_NULL_ID;
+    auto getMembers = [&]() {
+      auto numMembers = getCount();
+      for (std::size_t j = 0; j < numMembers; j++) {
+        auto memberName = getString();
+        auto memberLocation = getLocation();
+        refs.members.push_back(Member{memberName, memberLocation, getID()});
+      }
+    };
+    switch (kind) {
+    case SnapshotDType::BASIC: {
+      auto left = get<uint32_t>();
+      auto right = get<uint32_t>();
+      auto ranged = get<uint8_t>();
+      if (ranged) {
+        dtypes.push_back(std::make_shared<BasicDType>(name, location, left, right));
+      } else {
+        dtypes.push_back(std::make_shared<BasicDType>(name, location));
+      }
+      break;
+    }
+    case SnapshotDType::REF:
+      dtypes.push_back(std::make_shared<RefDType>(name, location));
+      refs.subDTypeID = getID();
+      break;
+    case SnapshotDType::ARRAY: {
+      auto start = get<uint64_t>();
+      auto end = get<uint64_t>();
+      auto packed = get<uint8_t>();
+      dtypes.push_back(std::make_shared<ArrayDType>(location, start, end, packed));
+      refs.subDTypeID = getID();
+      break;
+    }
+    case SnapshotDType::MEMBER:
+      dtypes.push_back(std::make_shared<MemberDType>(name, location, nullptr));
+      refs.subDTypeID = getID();
+      break;
+    case SnapshotDType::STRUCT:
+      dtypes.push_back(std::make_shared<StructDType>(name, location));
+      getMembers();
+      break;
+    case SnapshotDType::UNION:
+      dtypes.push_back(std::make_shared<UnionDType>(name, location));
+      getMembers();
+      break;
+    case SnapshotDType::ENUM: {
+      auto enumDType = std::make_shared<EnumDType>(name, location);
+      refs.subDTypeID = getID();
+      auto numItems = getCount();
+      for (std::size_t j = 0; j < numItems; j++) {
+        auto itemName = getString();
+        enumDType->addItem(EnumItem(itemName, get<uint64_t>()));
+      }
+      dtypes.push_back(enumDType);
+      break;
+    }
+    default:
+      throw Exception("corrupt netlist snapshot");
+    }
+  }
+  for (std::size_t i = 0; i < numDTypes; i++) {
+    auto dtype = dtypes[i].get();
+    auto subDType = getDType(references[i].subDTypeID);
+    if (auto refDType = dynamic_cast<RefDType*>(dtype)) {
+      refDType->setSubDType(subDType);
+    } else if (auto arrayDType = dynamic_cast<ArrayDType*>(dtype)) {
+      arrayDType->setSubDType(subDType);
+    } else if (auto memberDType = dynamic_cast<MemberDType*>(dtype)) {
+      memberDType->setSubDType(subDType);
+    } else if (auto enumDType = dynamic_cast<EnumDType*>(dtype)) {
+      enumDType->setSubDType(subDType);
+    }
+    for (auto &member : references[i].members) {
+      auto memberDType = MemberDType(member.name, member.location,
+                                     getDType(member.subDTypeID));
+      if (auto structDType = dynamic_cast<StructDType*>(dtype)) {
+        structDType->addMemberDType(memberDType);
+      } else {
+        dynamic_cast<UnionDType*>(dtype)->addMemberDType(memberDType);
+      }
+    }
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// Reading and writing netlists.
+//===----------------------------------------------------------------------===//
+
+void netlist_paths::writeSnapshot(const std::string &filename,
+                                  const Graph &graph,
+                                  const std::vector<File> &files,
+                                  const std::vector<std::shared_ptr<DType>> &dtypes) {
+  SnapshotWriter writer;
+  writer.put<uint64_t>(files.size());
+  for (auto &file : files) {
+    writer.putString(file.getFilename());
+    writer.putString(file.getLanguage());
+  }
+  for (auto &dtype : dtypes) {
+    writer.addDType(dtype);
+  }
+  for (std::size_t vertex = 0; vertex < graph.numVertices(); vertex++) {
+    writer.addDType(graph.getVertex(vertex).getDType());
+  }
+  writer.putDTypes();
+  writer.put<uint64_t>(dtypes.size());
+  for (auto &dtype : dtypes) {
+    writer.putDType(dtype);
+  }
+  graph.writeSnapshot(writer);
+  writer.write(filename);
+}
+
+void netlist_paths::readSnapshot(const std::string &filename,
+                                 Graph &graph,
+                                 std::vector<File> &files,
+                                 std::vector<std::shared_ptr<DType>> &dtypes) {
+  SnapshotReader reader(filename);
+  auto numFiles = reader.getCount();
+  for (std::size_t i = 0; i < numFiles; i++) {
+    auto filename = reader.getString();
+    auto language = reader.getString();
+    files.push_back(File(filename, language));
+  }
+  reader.setNumFiles(numFiles);
+  reader.getDTypes();
+  auto numDTypes = reader.getCount();
+  for (std::size_t i = 0; i < numDTypes; i++) {
+    dtypes.push_back(reader.getDType());
+  }
+  graph.readSnapshot(reader);
+  if (!reader.isEnd()) {
+    throw Exception(std::string("corrupt netlist snapshot ")+filename);
+  }
+}
@@ -0,0 +1,196 @@
+#ifndef NETLIST_PATHS_SNAPSHOT_HPP
+#define NETLIST_PATHS_SNAPSHOT_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "netlist_paths/DTypes.hpp"
+#include "netlist_paths/Exception.hpp"
+#include "netlist_paths/Graph.hpp"
+#include "netlist_paths/Location.hpp"
+#include "netlist_paths/MappedFile.hpp"
+
+namespace netlist_paths {
+
+/// The snapshot file format. A snapshot starts with a fixed header, followed
+/// by a payload containing the source files, data types, vertices, edges and
+/// aliases of a netlist. Values are stored in the byte order of the machine
+/// that wrote the snapshot, which is checked when it is read.
+constexpr char SNAPSHOT_MAGIC[8] = {'N', 'P', 'S', 'N', 'A', 'P', 0, 0};
+constexpr uint32_t SNAPSHOT_VERSION = 3;
+constexpr uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+constexpr uint32_t SNAPSHOT_NULL_ID = UINT32_MAX;
+
+struct SnapshotHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t byteOrder;
+  uint64_t payloadSize;
+  uint64_t checksum;
+};
+
+/// The kinds of data type stored in a snapshot.
+enum class SnapshotDType : uint8_t {
+  BASIC,
+  REF,
+  ARRAY,
+  MEMBER,
+  STRUCT,
+  UNION,
+  ENUM
+};
+
+/// FNV-1a hash of the snapshot payload, which can be continued over several
+/// pieces of it.
+inline uint64_t snapshotChecksum(const char *data, std::size_t size,
+                                 uint64_t value=14695981039346656037ULL) {
+  for (std::size_t i = 0; i < size; i++) {
+    value ^= static_cast<unsigned char>(data[i]);
+    value *= 1099511628211ULL;
+  }
+  return value;
+}
+
+/// Serialise a netlist into a snapshot.
+class SnapshotWriter {
+  std::string body;
+  std::map<const DType*, uint32_t> dtypeIDs;
+  std::vector<const DType*> dtypeOrder;
+
+public:
+  template<typename T>
+  void put(T value) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "snapshot values must be trivially copyable");
+    body.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  void putString(const std::string &value) {
+    put<uint64_t>(value.size());
+    body.append(value);
+  }
+
+  /// Return the number of a data type, which must have been added with
+  /// addDType.
+  uint32_t getDTypeID(const std::shared_ptr<DType> &dtype) const {
+    return dtype ? dtypeIDs.at(dtype.get()) : SNAPSHOT_NULL_ID;
+  }
+
+  /// Write a location, referring to its file by its index in the source files
+  /// of the netlist.
+  void putLocation(const Location &location);
+
+  /// Write a reference to a data type, which must have been added with
+  /// addDType.
+  void putDType(const std::shared_ptr<DType> &dtype) {
+    put<uint32_t>(getDTypeID(dtype));
+  }
+
+  /// Number a data type and those it refers to, so that they are stored in
+  /// the snapshot.
+  void addDType(const std::shared_ptr<DType> &dtype);
+
+  /// Write the definitions of all the data types that have been added.
+  void putDTypes();
+
+  /// Return the payload of the snapshot, which is everything that has been
+  /// written.
+  const std::string &getPayload() const { return body; }
+
+  /// Write the snapshot header and payload to a file.
+  void write(const std::string &filename) const;
+};
+
+/// Deserialise a netlist from a snapshot.
+class SnapshotReader {
+  std::unique_ptr<MappedFile> file;
+  const char *position;
+  const char *end;
+  std::size_t numFiles = 0;
+  std::vector<std::shared_ptr<DType>> dtypes;
+
+  void check(std::size_t size) {
+    if (static_cast<std::size_t>(end - position) < size) {
+      throw Exception("truncated netlist snapshot");
+    }
+  }
+
+public:
+  /// Open a snapshot and check its header and checksum.
+  ///
+  /// \param filename The path of the snapshot file.
+  SnapshotReader(const std::string &filename);
+
+  /// Read a snapshot payload held in memory, such as one embedded in another
+  /// file. The payload must outlive the reader.
+  ///
+  /// \param data A pointer to the payload.
+  /// \param size The size of the payload in bytes.
+  SnapshotReader(const char *data, std::size_t size);
+
+  template<typename T>
+  T get() {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "snapshot values must be trivially copyable");
+    check(sizeof(T));
+    T value;
+    std::memcpy(&value, position, sizeof(T));
+    position += sizeof(T);
+    return value;
+  }
+
+  std::string getString() {
+    auto size = get<uint64_t>();
+    check(size);
+    std::string value(position, size);
+    position += size;
+    return value;
+  }
+
+  /// Read a count of items, checking it is plausible for the remaining data.
+  std::size_t getCount(std::size_t minItemSize=1) {
+    auto count = get<uint64_t>();
+    if (count > static_cast<uint64_t>(end - position) / minItemSize) {
+      throw Exception("corrupt netlist snapshot");
+    }
+    return static_cast<std::size_t>(count);
+  }
+
+  Location getLocation();
+
+  std::shared_ptr<DType> getDType() { return getDType(get<uint32_t>()); }
+
+  /// Set the number of source files of the netlist, which the file indices
+  /// of locations read afterwards must be less than.
+  void setNumFiles(std::size_t value) { numFiles = value; }
+
+  /// Return a data type by its number, which must have been read with
+  /// getDTypes().
+  std::shared_ptr<DType> getDType(uint32_t id) const;
+
+  /// Read the definitions of all data types.
+  void getDTypes();
+
+  /// Return true if all of the payload has been read.
+  bool isEnd() const { return position == end; }
+};
+
+/// Write a netlist to a snapshot file.
+void writeSnapshot(const std::string &filename,
+                   const Graph &graph,
+                   const std::vector<File> &files,
+                   const std::vector<std::shared_ptr<DType>> &dtypes);
+
+/// Read a netlist from a snapshot file.
+void readSnapshot(const std::string &filename,
+                  Graph &graph,
+                  std::vector<File> &files,
+                  std::vector<std::shared_ptr<DType>> &dtypes);
+
+} // End netlist_paths namespace.
+
+#endif // NETLIST_PATHS_SNAPSHOT_HPP
@@ -0,0 +1,128 @@
+#include <memory>
+#include "netlist_paths/Options.hpp"
+#include "netlist_paths/ThreadPool.hpp"
+
+using namespace netlist_paths;
+
+namespace {
+
+/// True in the worker threads of any pool, and in a thread running a job of
+/// the shared pool, so that nested jobs are run serially.
+thread_local bool inPoolJob = false;
+
+} // End anonymous namespace.
+
+ThreadPool::ThreadPool(std::size_t numThreads) :
+    task(nullptr), numTasks(0), nextTask(0), numFinished(0),
+    numActiveWorkers(0), jobNumber(0), exceptionIndex(0), stopping(false) {
+  for (std::size_t i = 1; i < numThreads; i++) {
+    workers.emplace_back([this]() { workerLoop(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  jobStarted.notify_all();
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
+
+/// Take tasks of the current job until none are left. The lock is released
+/// while each task runs.
+void ThreadPool::runTasks(std::unique_lock<std::mutex> &lock) {
+  while (nextTask < numTasks) {
+    auto index = nextTask++;
+    lock.unlock();
+    std::exception_ptr taskException;
+    try {
+      (*task)(index);
+    } catch (...) {
+      taskException = std::current_exception();
+    }
+    lock.lock();
+    if (taskException && (!exception || index < exceptionIndex)) {
+      exception = taskException;
+      exceptionIndex = index;
+    }
+    numFinished++;
+  }
+}
+
+void ThreadPool::workerLoop() {
+  inPoolJob = true;
+  std::size_t lastJob = 0;
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    jobStarted.wait(lock, [&]() { return stopping || jobNumber != lastJob; });
+    if (stopping) {
+      return;
+    }
+    lastJob = jobNumber;
+    numActiveWorkers++;
+    runTasks(lock);
+    numActiveWorkers--;
+    if (numFinished == numTasks && numActiveWorkers == 0) {
+      jobFinished.notify_all();
+    }
+  }
+}
+
+/// The job does not finish until every worker that joined it has left, so
+/// that no worker still refers to the task when run() returns.
+void ThreadPool::run(std::size_t count, const std::function<void(std::size_t)> &function) {
+  if (workers.empty() || count <= 1) {
+    for (std::size_t i = 0; i < count; i++) {
+      function(i);
+    }
+    return;
+  }
+  std::unique_lock<std::mutex> lock(mutex);
+  task = &function;
+  numTasks = count;
+  nextTask = 0;
+  numFinished = 0;
+  exception = nullptr;
+  jobNumber++;
+  jobStarted.notify_all();
+  runTasks(lock);
+  jobFinished.wait(lock, [this]() {
+    return numFinished == numTasks && numActiveWorkers == 0;
+  });
+  task = nullptr;
+  numTasks = 0;
+  if (exception) {
+    auto jobException = exception;
+    exception = nullptr;
+    std::rethrow_exception(jobException);
+  }
+}
+
+void ThreadPool::runShared(std::size_t count,
+                           const std::function<void(std::size_t)> &function) {
+  if (inPoolJob) {
+    for (std::size_t i = 0; i < count; i++) {
+      function(i);
+    }
+    return;
+  }
+  static std::mutex sharedMutex;
+  static std::unique_ptr<ThreadPool> sharedPool;
+  std::lock_guard<std::mutex> lock(sharedMutex);
+  auto numThreads = Options::getInstance().getNumJobs();
+  if (!sharedPool || sharedPool->numThreads() != numThreads) {
+    sharedPool.reset();
+    sharedPool = std::make_unique<ThreadPool>(numThreads);
+  }
+  inPoolJob = true;
+  try {
+    sharedPool->run(count, function);
+  } catch (...) {
+    inPoolJob = false;
+    throw;
+  }
+  inPoolJob = false;
+}
@@ -0,0 +1,110 @@
+#ifndef NETLIST_PATHS_THREAD_POOL_HPP
+#define NETLIST_PATHS_THREAD_POOL_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "netlist_paths/Options.hpp"
+
+namespace netlist_paths {
+
+/// A fixed set of worker threads that run the tasks of one job at a time. A
+/// job is a number of tasks, identified by their indices, which the workers
+/// and the calling thread take in turn until none are left. The library
+/// shares a single pool, with the number of threads set by
+/// Options::setNumJobs().
+class ThreadPool {
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable jobStarted;
+  std::condition_variable jobFinished;
+  const std::function<void(std::size_t)> *task;
+  std::size_t numTasks;
+  std::size_t nextTask;
+  std::size_t numFinished;
+  std::size_t numActiveWorkers;
+  std::size_t jobNumber;
+  std::exception_ptr exception;
+  std::size_t exceptionIndex;
+  bool stopping;
+
+  void runTasks(std::unique_lock<std::mutex> &lock);
+  void workerLoop();
+
+public:
+  /// Create a pool that runs each job on a number of threads, including the
+  /// thread that runs the job.
+  explicit ThreadPool(std::size_t numThreads);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  void operator=(const ThreadPool&) = delete;
+
+  /// Return the number of threads that run each job.
+  std::size_t numThreads() const { return workers.size() + 1; }
+
+  /// Run a task with each index from 0 to numTasks-1 and return when all of
+  /// them have finished. If any tasks throw, the exception of the task with
+  /// the lowest index is rethrown once the others have finished.
+  void run(std::size_t numTasks, const std::function<void(std::size_t)> &task);
+
+  /// Run a job on the pool shared by the library, which is resized when the
+  /// number of jobs option changes. Jobs are run one at a time, and a job run
+  /// from within a task is run serially by the calling thread.
+  static void runShared(std::size_t numTasks,
+                        const std::function<void(std::size_t)> &task);
+};
+
+/// Divide a range of IDs into chunks, find the IDs in each chunk that satisfy
+/// a predicate on the shared thread pool, and concatenate the results of the
+/// chunks in order, so the result is the same as a serial scan whatever the
+/// number of threads. Ranges smaller than minParallelScan, and all ranges when
+/// there is a single thread, are scanned serially to avoid the cost of
+/// starting a job.
+template<typename ID, typename Predicate>
+std::vector<ID> parallelScan(ID begin, ID end, Predicate predicate) {
+  const std::size_t minParallelScan = 1 << 15;
+  const std::size_t chunksPerThread = 4;
+  auto numThreads = Options::getInstance().getNumJobs();
+  std::vector<ID> result;
+  std::size_t size = end > begin ? end - begin : 0;
+  if (numThreads <= 1 || size < minParallelScan) {
+    for (auto id = begin; id < end; id++) {
+      if (predicate(id)) {
+        result.push_back(id);
+      }
+    }
+    return result;
+  }
+  // Several chunks per thread balance the work when matches are clustered.
+  auto numChunks = numThreads * chunksPerThread;
+  auto chunkSize = (size + numChunks - 1) / numChunks;
+  std::vector<std::vector<ID>> chunkResults(numChunks);
+  ThreadPool::runShared(numChunks, [&](std::size_t chunk) {
+    auto first = begin + static_cast<ID>(std::min(chunk * chunkSize, size));
+    auto last = begin + static_cast<ID>(std::min((chunk + 1) * chunkSize, size));
+    for (auto id = first; id < last; id++) {
+      if (predicate(id)) {
+        chunkResults[chunk].push_back(id);
+      }
+    }
+  });
+  std::size_t total = 0;
+  for (auto &chunkResult : chunkResults) {
+    total += chunkResult.size();
+  }
+  result.reserve(total);
+  for (auto &chunkResult : chunkResults) {
+    result.insert(result.end(), chunkResult.begin(), chunkResult.end());
+  }
+  return result;
+}
+
+} // End netlist_paths namespace.
+
+#endif // NETLIST_PATHS_THREAD_POOL_HPP
@@ -0,0 +1,152 @@
+#ifndef NETLIST_PATHS_VAR_TABLE_HPP
+#define NETLIST_PATHS_VAR_TABLE_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <vector>
+#include "netlist_paths/Exception.hpp"
+#include "netlist_paths/Graph.hpp"
+
+namespace netlist_paths {
+
+/// An open-addressing hash table mapping variable names to vertices. Names
+/// are interned in a character arena owned by the table, and entries refer to
+/// them by a 64-bit offset, since the names of a large netlist can exceed
+/// 4 GiB. Lookups take string views, including the concatenation of a prefix
+/// and a name, so that no temporary strings are created.
+class VarTable {
+  struct Entry {
+    uint64_t hash;
+    uint64_t nameOffset;
+    uint32_t nameLength;
+    VertexID vertex;
+    bool isEmpty() const { return nameLength == EMPTY; }
+  };
+
+  static constexpr uint32_t EMPTY = std::numeric_limits<uint32_t>::max();
+  static constexpr std::size_t INITIAL_CAPACITY = 1024;
+
+  std::vector<Entry> entries;
+  std::vector<char> names;
+  std::size_t numEntries;
+
+  /// FNV-1a hashing, which can be continued over several pieces of a name.
+  static constexpr uint64_t HASH_SEED = 14695981039346656037ULL;
+  static uint64_t hash(std::string_view piece, uint64_t value=HASH_SEED) {
+    for (char c : piece) {
+      value ^= static_cast<unsigned char>(c);
+      value *= 1099511628211ULL;
+    }
+    return value;
+  }
+
+  std::size_t mask() const { return entries.size() - 1; }
+
+  std::string_view getName(const Entry &entry) const {
+    return std::string_view(names.data() + entry.nameOffset, entry.nameLength);
+  }
+
+  void grow() {
+    std::vector<Entry> oldEntries(entries.size() * 2,
+                                  Entry{0, 0, EMPTY, VertexID()});
+    oldEntries.swap(entries);
+    for (auto &entry : oldEntries) {
+      if (!entry.isEmpty()) {
+        auto index = entry.hash & mask();
+        while (!entries[index].isEmpty()) {
+          index = (index + 1) & mask();
+        }
+        entries[index] = entry;
+      }
+    }
+  }
+
+  /// Return the entry matching a name formed from a prefix, separator and
+  /// suffix (the prefix and separator can be empty), or nullptr.
+  const Entry *findEntry(uint64_t nameHash,
+                         std::string_view prefix,
+                         std::string_view separator,
+                         std::string_view suffix) const {
+    auto length = prefix.size() + separator.size() + suffix.size();
+    auto index = nameHash & mask();
+    while (!entries[index].isEmpty()) {
+      auto &entry = entries[index];
+      if (entry.hash == nameHash && entry.nameLength == length) {
+        auto name = getName(entry);
+        if (name.compare(0, prefix.size(), prefix) == 0 &&
+            name.compare(prefix.size(), separator.size(), separator) == 0 &&
+            name.compare(prefix.size() + separator.size(),
+                         suffix.size(), suffix) == 0) {
+          return &entry;
+        }
+      }
+      index = (index + 1) & mask();
+    }
+    return nullptr;
+  }
+
+public:
+  VarTable() :
+      entries(INITIAL_CAPACITY, Entry{0, 0, EMPTY, VertexID()}),
+      numEntries(0) {}
+
+  /// Add a variable, unless one with the same name already exists.
+  ///
+  /// \param name   The variable name.
+  /// \param vertex The vertex of the variable.
+  ///
+  /// \returns True if the variable was added.
+  bool insert(std::string_view name, VertexID vertex) {
+    if (name.size() >= EMPTY) {
+      throw Exception("variable name is too long");
+    }
+    auto nameHash = hash(name);
+    if (findEntry(nameHash, {}, {}, name)) {
+      return false;
+    }
+    // Keep the load factor at most one half.
+    if ((numEntries + 1) * 2 > entries.size()) {
+      grow();
+    }
+    auto index = nameHash & mask();
+    while (!entries[index].isEmpty()) {
+      index = (index + 1) & mask();
+    }
+    entries[index] = Entry{nameHash,
+                           names.size(),
+                           static_cast<uint32_t>(name.size()),
+                           vertex};
+    names.insert(names.end(), name.begin(), name.end());
+    numEntries++;
+    return true;
+  }
+
+  /// Lookup a variable by name.
+  ///
+  /// \returns A pointer to the vertex of the variable, or nullptr.
+  const VertexID *find(std::string_view name) const {
+    auto entry = findEntry(hash(name), {}, {}, name);
+    return entry ? &entry->vertex : nullptr;
+  }
+
+  /// Lookup a variable by a name formed from a prefix, a separator and a
+  /// suffix, without constructing the name.
+  ///
+  /// \returns A pointer to the vertex of the variable, or nullptr.
+  const VertexID *find(std::string_view prefix,
+                       std::string_view separator,
+                       std::string_view suffix) const {
+    auto nameHash = hash(suffix, hash(separator, hash(prefix)));
+    auto entry = findEntry(nameHash, prefix, separator, suffix);
+    return entry ? &entry->vertex : nullptr;
+  }
+
+  /// Return the number of variables in the table.
+  std::size_t size() const { return numEntries; }
+};
+
+} // End netlist_paths namespace.
+
+#endif // NETLIST_PATHS_VAR_TABLE_HPP
@@ -0,0 +1,184 @@
+#include "netlist_paths/Exception.hpp"
+#include "netlist_paths/XMLStream.hpp"
+
+using namespace netlist_paths;
+
+XMLStream::XMLStream(const std::string &filename, std::size_t bufferSize) :
+    file(filename, std::ios::in | std::ios::binary),
+    buffer(bufferSize), bufferPos(0), bufferEnd(0),
+    node(nullptr), pendingClose(false) {
+  if (!file.is_open()) {
+    throw Exception(std::string("could not open file ")+filename);
+  }
+}
+
+/// Return the next character of the input, refilling the buffer as required.
+/// Return false at the end of the input.
+bool XMLStream::getChar(char &c) {
+  if (bufferPos == bufferEnd) {
+    file.read(buffer.data(), buffer.size());
+    bufferPos = 0;
+    bufferEnd = static_cast<std::size_t>(file.gcount());
+    if (bufferEnd == 0) {
+      return false;
+    }
+  }
+  c = buffer[bufferPos++];
+  return true;
+}
+
+void XMLStream::getCharOrThrow(char &c) {
+  if (!getChar(c)) {
+    throw XMLException("unexpected end of XML stream");
+  }
+}
+
+/// Read the next markup item (a tag, comment, declaration or processing
+/// instruction) into the token buffer, discarding any character data
+/// preceding it. Return false at the end of the input.
+bool XMLStream::readMarkup() {
+  char c;
+  do {
+    if (!getChar(c)) {
+      return false;
+    }
+  } while (c != '<');
+  token.assign(1, '<');
+  getCharOrThrow(c);
+  token.push_back(c);
+  if (c == '?') {
+    // Processing instruction, terminated by '?>'.
+    do {
+      getCharOrThrow(c);
+      token.push_back(c);
+    } while (!(token.size() >= 4 && token.compare(token.size()-2, 2, "?>") == 0));
+  } else if (c == '!') {
+    // Comment terminated by '-->', or a declaration terminated by '>'.
+    bool comment = false;
+    while (true) {
+      getCharOrThrow(c);
+      token.push_back(c);
+      if (token.size() == 4 && token.compare(0, 4, "<!--") == 0) {
+        comment = true;
+      }
+      if (comment) {
+        if (token.size() >= 7 && token.compare(token.size()-3, 3, "-->") == 0) {
+          break;
+        }
+      } else if (c == '>') {
+        break;
+      }
+    }
+  } else {
+    // Start or end tag, terminated by a '>' outside of an attribute value.
+    char quote = 0;
+    while (c != '>' || quote) {
+      getCharOrThrow(c);
+      token.push_back(c);
+      if (quote) {
+        if (c == quote) {
+          quote = 0;
+        }
+      } else if (c == '"' || c == '\'') {
+        quote = c;
+      }
+    }
+  }
+  return true;
+}
+
+XMLStream::Markup XMLStream::getMarkupKind() const {
+  if (token[1] == '?' || token[1] == '!') {
+    return Markup::OTHER;
+  }
+  if (token[1] == '/') {
+    return Markup::END;
+  }
+  if (token[token.size()-2] == '/') {
+    return Markup::EMPTY;
+  }
+  return Markup::START;
+}
+
+std::string XMLStream::getMarkupName() const {
+  std::size_t start = token[1] == '/' ? 2 : 1;
+  std::size_t end = token.find_first_of(" \t\r\n/>", start);
+  return token.substr(start, end - start);
+}
+
+XMLStream::Node *XMLStream::parseElementText() {
+  elementText.push_back('\0');
+  doc.clear();
+  doc.parse<0>(elementText.data());
+  return doc.first_node();
+}
+
+XMLStream::Event XMLStream::next(const ContainerPredicate &isContainer) {
+  node = nullptr;
+  if (pendingClose) {
+    // Close an empty container element.
+    pendingClose = false;
+    return Event::CLOSE;
+  }
+  while (readMarkup()) {
+    auto kind = getMarkupKind();
+    if (kind == Markup::OTHER) {
+      continue;
+    }
+    name = getMarkupName();
+    if (kind == Markup::END) {
+      return Event::CLOSE;
+    }
+    if (isContainer(name)) {
+      // Parse the start tag as an empty element to provide its attributes.
+      elementText.assign(token.begin(), token.end());
+      if (kind == Markup::START) {
+        elementText.back() = '/';
+        elementText.push_back('>');
+      }
+      node = parseElementText();
+      pendingClose = kind == Markup::EMPTY;
+      return Event::OPEN;
+    }
+    // Capture the complete element.
+    elementText.assign(token.begin(), token.end());
+    std::size_t depth = kind == Markup::START ? 1 : 0;
+    while (depth > 0) {
+      if (!readMarkup()) {
+        throw XMLException(std::string("unterminated element ")+name);
+      }
+      auto childKind = getMarkupKind();
+      if (childKind == Markup::OTHER) {
+        continue;
+      }
+      if (childKind == Markup::START) {
+        depth++;
+      } else if (childKind == Markup::END) {
+        depth--;
+      }
+      elementText.insert(elementText.end(), token.begin(), token.end());
+    }
+    node = parseElementText();
+    return Event::ELEMENT;
+  }
+  return Event::END;
+}
+
+void XMLStream::skip() {
+  if (pendingClose) {
+    pendingClose = false;
+    return;
+  }
+  std::size_t depth = 1;
+  while (depth > 0) {
+    if (!readMarkup()) {
+      throw XMLException(std::string("unterminated element ")+name);
+    }
+    auto kind = getMarkupKind();
+    if (kind == Markup::START) {
+      depth++;
+    } else if (kind == Markup::END) {
+      depth--;
+    }
+  }
+}
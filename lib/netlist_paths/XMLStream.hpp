@@ -0,0 +1,95 @@
+#ifndef NETLIST_PATHS_XML_STREAM_HPP
+#define NETLIST_PATHS_XML_STREAM_HPP
+
+#include <cstddef>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+#include <rapidxml-1.13/rapidxml.hpp>
+
+namespace netlist_paths {
+
+/// The default size of the buffer used to read an XML stream.
+constexpr std::size_t DEFAULT_XML_STREAM_BUFFER_SIZE = 1 << 20;
+
+/// A pull-based reader of an XML document that never holds more than a
+/// bounded amount of the document in memory.
+///
+/// The reader distinguishes between 'container' elements, which are reported
+/// as separate open and close events, and all other elements, which are read
+/// in their entirety and returned as a small DOM tree. The tree returned for
+/// an element, or for the start tag of a container, remains valid until the
+/// next call to next().
+class XMLStream {
+public:
+  using Node = rapidxml::xml_node<>;
+
+  /// Events produced by the stream.
+  enum class Event {
+    OPEN,    ///< The start tag of a container (getNode() has its attributes).
+    CLOSE,   ///< The end tag of a container (getName() has its name).
+    ELEMENT, ///< A complete element (getNode() has its tree).
+    END      ///< The end of the document.
+  };
+
+  /// A predicate to determine whether an element name is a container.
+  using ContainerPredicate = std::function<bool(const std::string&)>;
+
+private:
+  enum class Markup {
+    START,
+    END,
+    EMPTY,
+    OTHER
+  };
+
+  std::ifstream file;
+  std::vector<char> buffer;
+  std::size_t bufferPos;
+  std::size_t bufferEnd;
+  std::string token;
+  std::vector<char> elementText;
+  rapidxml::xml_document<> doc;
+  Node *node;
+  std::string name;
+  bool pendingClose;
+
+  bool getChar(char &c);
+  void getCharOrThrow(char &c);
+  bool readMarkup();
+  Markup getMarkupKind() const;
+  std::string getMarkupName() const;
+  Node *parseElementText();
+
+public:
+  XMLStream() = delete;
+
+  /// Open an XML file for streaming.
+  ///
+  /// \param filename   The path of the XML file.
+  /// \param bufferSize The size of the buffer used to read the file.
+  XMLStream(const std::string &filename,
+            std::size_t bufferSize=DEFAULT_XML_STREAM_BUFFER_SIZE);
+
+  /// Read up to the next event in the document.
+  ///
+  /// \param isContainer A predicate identifying container element names.
+  ///
+  /// \returns The type of the event.
+  Event next(const ContainerPredicate &isContainer);
+
+  /// Discard the contents of the most recently opened container, including
+  /// its end tag, so that no close event is produced for it.
+  void skip();
+
+  /// Return the node of an open or element event.
+  Node *getNode() const { return node; }
+
+  /// Return the element name of the last event.
+  const std::string &getName() const { return name; }
+};
+
+} // End netlist_paths namespace.
+
+#endif // NETLIST_PATHS_XML_STREAM_HPP
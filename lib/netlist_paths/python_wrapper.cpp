@@ -1,9 +1,14 @@
+#include <algorithm>
+#include <memory>
+#include <vector>
 #include <boost/python.hpp>
 #include <boost/python/suite/indexing/vector_indexing_suite.hpp>
 #include "netlist_paths/DTypes.hpp"
 #include "netlist_paths/Exception.hpp"
 #include "netlist_paths/Netlist.hpp"
 #include "netlist_paths/Options.hpp"
+#include "netlist_paths/PathEnumerator.hpp"
+#include "netlist_paths/ReachabilityMatrix.hpp"
 #include "netlist_paths/RunVerilator.hpp"
 #include "netlist_paths/Vertex.hpp"
 #include "netlist_paths/Waypoints.hpp"
@@ -16,6 +21,94 @@ void translateXMLException(const netlist_paths::XMLException& e) {
   PyErr_SetString(PyExc_RuntimeError, e.what());
 }
 
+/// The netlists owned by Python, so that a vertex can be resolved to the
+/// netlist it belongs to. Python holds the global interpreter lock when the
+/// list is accessed.
+std::vector<const netlist_paths::Netlist*> &getNetlists() {
+  static std::vector<const netlist_paths::Netlist*> netlists;
+  return netlists;
+}
+
+/// Pass ownership of a netlist to Python, recording it until it is deleted.
+std::shared_ptr<netlist_paths::Netlist>
+ownNetlist(std::unique_ptr<netlist_paths::Netlist> netlist) {
+  getNetlists().push_back(netlist.get());
+  return std::shared_ptr<netlist_paths::Netlist>(netlist.release(),
+                                                 [](netlist_paths::Netlist *netlist) {
+    auto &netlists = getNetlists();
+    netlists.erase(std::find(netlists.begin(), netlists.end(), netlist));
+    delete netlist;
+  });
+}
+
+/// Read a netlist from an XML file, passing ownership of the netlist to Python.
+std::shared_ptr<netlist_paths::Netlist> createNetlist(const std::string &filename) {
+  return ownNetlist(std::make_unique<netlist_paths::Netlist>(filename));
+}
+
+/// Load a netlist snapshot, passing ownership of the netlist to Python.
+std::shared_ptr<netlist_paths::Netlist> loadNetlist(const std::string &filename) {
+  return ownNetlist(netlist_paths::Netlist::load(filename));
+}
+
+/// Open a netlist image, passing ownership of the netlist to Python.
+std::shared_ptr<netlist_paths::Netlist> openNetlistImage(const std::string &filename) {
+  return ownNetlist(netlist_paths::Netlist::openImage(filename));
+}
+
+/// Return the source location of a vertex, with the name of its file, from
+/// the netlist it belongs to. Netlist.get_location_str(vertex) avoids the
+/// search for the netlist.
+std::string getVertexLocationStr(const netlist_paths::Vertex &vertex) {
+  for (auto netlist : getNetlists()) {
+    if (netlist->ownsVertex(&vertex)) {
+      return netlist->getLocationStr(&vertex);
+    }
+  }
+  throw netlist_paths::Exception("vertex does not belong to a netlist");
+}
+
+/// Create a path enumerator, passing ownership of it to Python.
+netlist_paths::PathEnumerator *iterPaths(const netlist_paths::Netlist &netlist,
+                                         netlist_paths::Waypoints waypoints) {
+  return netlist.getPathEnumerator(waypoints).release();
+}
+
+/// Return the next path of an enumerator, as a Python iterator does.
+std::vector<netlist_paths::Vertex*> nextPath(netlist_paths::PathEnumerator &enumerator) {
+  if (!enumerator.next()) {
+    PyErr_SetNone(PyExc_StopIteration);
+    boost::python::throw_error_already_set();
+  }
+  return enumerator.getPath();
+}
+
+/// Convert pairs of a vertex and a path count to a list of tuples.
+boost::python::list
+pathCountList(const std::vector<std::pair<netlist_paths::Vertex*, uint64_t> > &counts) {
+  boost::python::list result;
+  for (auto &count : counts) {
+    result.append(boost::python::make_tuple(boost::python::ptr(count.first),
+                                            count.second));
+  }
+  return result;
+}
+
+boost::python::list countFanOutPaths(const netlist_paths::Netlist &netlist,
+                                     const std::string &startName) {
+  return pathCountList(netlist.countFanOutPaths(startName));
+}
+
+boost::python::list countFanInPaths(const netlist_paths::Netlist &netlist,
+                                    const std::string &endName) {
+  return pathCountList(netlist.countFanInPaths(endName));
+}
+
+/// Return an object itself, as the __iter__ method of an iterator does.
+boost::python::object passThrough(const boost::python::object &object) {
+  return object;
+}
+
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(get_named_vertices_overloads,
                                        getNamedVerticesPtr, 0, 1)
 
@@ -49,14 +142,15 @@ BOOST_PYTHON_MODULE(py_netlist_paths)
      .def("to_str",     &DType::toString);
 
   class_<Vertex, Vertex*, boost::noncopyable>("Vertex")
-     .def("get_name",          &Vertex::getName)
+     .def("get_name",          &Vertex::getName,
+                               return_value_policy<copy_const_reference>())
      .def("get_ast_type_str",  &Vertex::getSimpleAstTypeStr)
      .def("get_direction_str", &Vertex::getDirStr)
      .def("get_dtype",         &Vertex::getDTypePtr,
                                return_value_policy<reference_existing_object>())
      .def("get_dtype_str",     &Vertex::getDTypeStr)
      .def("get_dtype_width",   &Vertex::getDTypeWidth)
-     .def("get_location_str",  &Vertex::getLocationStr)
+     .def("get_location_str",  &getVertexLocationStr)
      .def("is_top",            &Vertex::isTop)
      .def("is_logic",          &Vertex::isLogic)
      .def("is_parameter",      &Vertex::isParameter)
@@ -84,12 +178,16 @@ BOOST_PYTHON_MODULE(py_netlist_paths)
     .def("set_match_exact",               &Options::setMatchExact)
     .def("set_match_wildcard",            &Options::setMatchWildcard)
     .def("set_match_regex",               &Options::setMatchRegex)
+    .def("set_regex_engine_std",          &Options::setRegexEngineStd)
+    .def("set_regex_engine_boost",        &Options::setRegexEngineBoost)
     .def("set_match_any_vertex",          &Options::setMatchAnyVertex)
     .def("set_match_one_vertex",          &Options::setMatchOneVertex)
     .def("set_traverse_registers",        &Options::setTraverseRegisters)
     .def("set_restrict_start_points",     &Options::setRestrictStartPoints)
     .def("set_restrict_end_points",       &Options::setRestrictEndPoints)
-    .def("set_ignore_hierarchy_markers",  &Options::setIgnoreHierarchyMarkers);
+    .def("set_ignore_hierarchy_markers",  &Options::setIgnoreHierarchyMarkers)
+    .def("set_stream_xml",                &Options::setStreamXML)
+    .def("set_num_jobs",                  &Options::setNumJobs);
 
   int (RunVerilator::*run)(const std::string&, const std::string&) const = &RunVerilator::run;
 
@@ -104,8 +202,25 @@ BOOST_PYTHON_MODULE(py_netlist_paths)
     .def("add_through_point",    &Waypoints::addThroughPoint)
     .def("add_avoid_point",      &Waypoints::addAvoidPoint);
 
-  class_<Netlist, boost::noncopyable>("Netlist",
-                                      init<const std::string&>())
+  class_<PathEnumerator, boost::noncopyable>("PathEnumerator", no_init)
+    .def("__iter__", &passThrough)
+    .def("__next__", &nextPath);
+
+  class_<ReachabilityMatrix>("ReachabilityMatrix", no_init)
+    .def("num_start_points",  &ReachabilityMatrix::numStartPoints)
+    .def("num_end_points",    &ReachabilityMatrix::numEndPoints)
+    .def("get_start_points",  &ReachabilityMatrix::getStartPoints,
+                              return_value_policy<copy_const_reference>())
+    .def("get_end_points",    &ReachabilityMatrix::getEndPoints,
+                              return_value_policy<copy_const_reference>())
+    .def("reaches",           &ReachabilityMatrix::reaches)
+    .def("get_row",           &ReachabilityMatrix::getRow)
+    .def("get_column",        &ReachabilityMatrix::getColumn)
+    .def("count",             &ReachabilityMatrix::count)
+    .def("memory_usage",      &ReachabilityMatrix::memoryUsage);
+
+  class_<Netlist, std::shared_ptr<Netlist>, boost::noncopyable>("Netlist", no_init)
+    .def("__init__",               make_constructor(&createNetlist))
     .def("get_named_vertices",     &Netlist::getNamedVerticesPtr,
                                    get_named_vertices_overloads())
     .def("get_reg_vertices",       &Netlist::getRegVerticesPtr,
@@ -114,6 +229,8 @@ BOOST_PYTHON_MODULE(py_netlist_paths)
                                    get_net_vertices_overloads())
     .def("get_port_vertices",      &Netlist::getPortVerticesPtr,
                                    get_port_vertices_overloads())
+    .def("get_vertices_under_scope", &Netlist::getVerticesUnderScope)
+    .def("get_location_str",       &Netlist::getLocationStr)
     .def("reg_exists",             &Netlist::regExists)
     .def("any_reg_exists",         &Netlist::anyRegExists)
     .def("startpoint_exists",      &Netlist::startpointExists)
@@ -121,14 +238,31 @@ BOOST_PYTHON_MODULE(py_netlist_paths)
     .def("any_startpoint_exists",  &Netlist::anyStartpointExists)
     .def("any_endpoint_exists",    &Netlist::anyEndpointExists)
     .def("path_exists",            &Netlist::pathExists)
+    .def("build_reachability_index", &Netlist::buildReachabilityIndex)
     .def("get_any_path",           &Netlist::getAnyPath)
     .def("get_all_paths",          &Netlist::getAllPaths)
+    .def("iter_paths",             &iterPaths,
+                                   return_value_policy<manage_new_object,
+                                     with_custodian_and_ward_postcall<0, 1> >())
     .def("get_all_fanout_paths",   &Netlist::getAllFanOut)
     .def("get_all_fanin_paths",    &Netlist::getAllFanIn)
+    .def("get_reachability_matrix", &Netlist::getReachabilityMatrix)
+    .def("get_fanout_degree",      &Netlist::getFanOutDegree)
+    .def("get_fanin_degree",       &Netlist::getFanInDegree)
+    .def("count_paths",            &Netlist::countPaths)
+    .def("count_fanout_paths",     &countFanOutPaths)
+    .def("count_fanin_paths",      &countFanInPaths)
+    .def("get_loops",              &Netlist::getLoops)
     .def("get_dtype_width",        &Netlist::getDTypeWidth)
     .def("get_vertex_dtype_str",   &Netlist::getVertexDTypeStr,
                                    get_vertex_dtype_str_overloads())
     .def("get_vertex_dtype_width", &Netlist::getVertexDTypeWidth,
                                    get_vertex_dtype_width_overloads())
-    .def("dump_dot_file",          &Netlist::dumpDotFile);
+    .def("dump_dot_file",          &Netlist::dumpDotFile)
+    .def("save",                   &Netlist::save)
+    .def("load",                   &loadNetlist)
+    .staticmethod("load")
+    .def("save_image",             &Netlist::saveImage)
+    .def("open_image",             &openNetlistImage)
+    .staticmethod("open_image");
 }
@@ -3,9 +3,11 @@
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MAIN
 
+#include <stdexcept>
 #include <boost/test/unit_test.hpp>
 #include "tests/definitions.hpp"
 #include "TestContext.hpp"
+#include "netlist_paths/ThreadPool.hpp"
 #include "netlist_paths/Utilities.hpp"
 
 //===----------------------------------------------------------------------===//
@@ -65,6 +67,80 @@ BOOST_AUTO_TEST_CASE(wildcard_matching) {
   BOOST_TEST(netlist_paths::wildcardMatch("mississippi", "*s*p*"));
   BOOST_TEST(netlist_paths::wildcardMatch("mississippi", "**s*p**"));
   BOOST_TEST(netlist_paths::wildcardMatch("mississippi", "mi*i*i*i"));
+  BOOST_TEST(netlist_paths::wildcardMatch("", ""));
+  BOOST_TEST(netlist_paths::wildcardMatch("", "*"));
+  BOOST_TEST(netlist_paths::wildcardMatch("a.b", "a*b"));
+  BOOST_TEST(netlist_paths::wildcardMatch("aaa", "a*a"));
+  BOOST_TEST(!netlist_paths::wildcardMatch("", "?"));
+  BOOST_TEST(!netlist_paths::wildcardMatch("foo", "fo"));
+  BOOST_TEST(!netlist_paths::wildcardMatch("foo", "foo?"));
+  BOOST_TEST(!netlist_paths::wildcardMatch("foo", "*of"));
+  BOOST_TEST(!netlist_paths::wildcardMatch("a", "a*a"));
+  BOOST_TEST(!netlist_paths::wildcardMatch("in", "*.?"));
+  BOOST_TEST(!netlist_paths::wildcardMatch("top.in", "*.?"));
+  BOOST_TEST(!netlist_paths::wildcardMatch("mississippi", "mi*i*i*i*i*i"));
+  // Many stars against a long text that does not match.
+  BOOST_TEST(!netlist_paths::wildcardMatch(std::string(10000, 'a'), "*a*a*a*a*a*a*a*a*b*"));
+}
+
+/// Test the literals required by regular expressions.
+BOOST_AUTO_TEST_CASE(regex_literals) {
+  using Literals = std::vector<std::string>;
+  BOOST_TEST(netlist_paths::getRequiredRegexLiterals("foo") == Literals({"foo"}));
+  BOOST_TEST(netlist_paths::getRequiredRegexLiterals("top.core0.*data_q") ==
+             Literals({"top", "core0", "data_q"}));
+  BOOST_TEST(netlist_paths::getRequiredRegexLiterals("top\\.core[0-9]+") ==
+             Literals({"top.core"}));
+  BOOST_TEST(netlist_paths::getRequiredRegexLiterals("abc?d") == Literals({"ab", "d"}));
+  BOOST_TEST(netlist_paths::getRequiredRegexLiterals("ab{0,2}c") == Literals({"a", "c"}));
+  BOOST_TEST(netlist_paths::getRequiredRegexLiterals("a(bc)*d") == Literals({"a", "d"}));
+  BOOST_TEST(netlist_paths::getRequiredRegexLiterals("\\x41bc\\dxyz") == Literals({}));
+  BOOST_TEST(netlist_paths::getRequiredRegexLiterals("\\d\\.q") == Literals({".q"}));
+  BOOST_TEST(netlist_paths::getRequiredRegexLiterals("[[:digit:]]+").empty());
+  BOOST_TEST(netlist_paths::getRequiredRegexLiterals("sig[[:digit:]]") == Literals({"sig"}));
+  BOOST_TEST(netlist_paths::getRequiredRegexLiterals("a[^[.].][=x=]]b") == Literals({"a", "b"}));
+  BOOST_TEST(netlist_paths::getRequiredRegexLiterals("foo|bar").empty());
+  BOOST_TEST(netlist_paths::getRequiredRegexLiterals("(?i)foo").empty());
+}
+
+/// Test the compiled form of wildcard patterns.
+BOOST_AUTO_TEST_CASE(wildcard_pattern) {
+  netlist_paths::WildcardPattern pattern("top.core0.*.data_q");
+  BOOST_TEST(pattern.getLiteralPrefix() == "top.core0.");
+  BOOST_TEST(pattern.match("top.core0.lsu.data_q"));
+  BOOST_TEST(!pattern.match("top.core1.lsu.data_q"));
+  BOOST_TEST(netlist_paths::WildcardPattern("*.x").getLiteralPrefix().empty());
+  netlist_paths::WildcardPattern markers("top.core0", true);
+  BOOST_TEST(markers.getLiteralPrefix() == "top");
+  BOOST_TEST(markers.match("top/core0"));
+  BOOST_TEST(markers.match("top_core0"));
+  BOOST_TEST(!markers.match("topcore0"));
+}
+
+/// Test that scans divided between threads find the same IDs in the same
+/// order as a serial scan, and pass on exceptions in task order.
+BOOST_AUTO_TEST_CASE(parallel_scan) {
+  auto predicate = [](std::size_t i) { return i % 7 == 0 || i % 1000 < 3; };
+  auto serial = netlist_paths::parallelScan(std::size_t(0), std::size_t(100000), predicate);
+  netlist_paths::Options::getInstance().setNumJobs(4);
+  auto parallel = netlist_paths::parallelScan(std::size_t(0), std::size_t(100000), predicate);
+  BOOST_TEST(parallel == serial, boost::test_tools::per_element());
+  BOOST_CHECK_THROW(netlist_paths::parallelScan(std::size_t(0), std::size_t(100000),
+                                                [](std::size_t) -> bool {
+                                                  throw std::runtime_error("scan");
+                                                }),
+                    std::runtime_error);
+  // The exception of the task with the lowest index is passed on.
+  for (int trial = 0; trial < 10; trial++) {
+    BOOST_CHECK_EXCEPTION(netlist_paths::ThreadPool::runShared(64, [](std::size_t i) {
+                            if (i % 8 == 3) {
+                              throw std::runtime_error(std::to_string(i));
+                            }
+                          }),
+                          std::runtime_error,
+                          [](const std::runtime_error &e) { return e.what() == std::string("3"); });
+  }
+  netlist_paths::Options::getInstance().setNumJobs(1);
 }
 
 /// Test matching of names by wildcards and regexes.
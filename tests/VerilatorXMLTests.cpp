@@ -3,6 +3,8 @@
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MAIN
 
+#include <algorithm>
+#include <fstream>
 #include <boost/test/unit_test.hpp>
 #include "tests/definitions.hpp"
 #include "TestContext.hpp"
@@ -45,6 +47,12 @@ BOOST_FIXTURE_TEST_CASE(dtype_forward_refs, TestContext) {
   BOOST_CHECK_NO_THROW(load("dtype_forward_refs.xml"));
 }
 
+/// A reference to a dtype that is not in the typetable is reported once the
+/// whole table has been read.
+BOOST_FIXTURE_TEST_CASE(dtype_missing_sub, TestContext) {
+  BOOST_CHECK_THROW(load("dtype_missing_sub.xml"), netlist_paths::XMLException);
+}
+
 /// Verilator can introduce new variables that are the target of delayed
 /// assignments. Since the LHS of delayed assignments are how registers are
 /// identified, register types are propagated through assign aliases.
@@ -53,3 +61,431 @@ BOOST_FIXTURE_TEST_CASE(assign_alias_regs, TestContext) {
   BOOST_TEST(np->regExists("assign_alias_regs.sum.add.register_q"));
   BOOST_TEST(np->regExists("assign_alias_regs.__Vcellout__sum.add__register_q"));
 }
+
+/// Combinational paths fan out from an input port through the registers and
+/// fan in to an output port.
+BOOST_FIXTURE_TEST_CASE(fan_out_in, TestContext) {
+  BOOST_CHECK_NO_THROW(load("fan_out_in.xml"));
+  auto paths = np->getAllFanOut("in");
+  BOOST_TEST(paths.size() == 3);
+  BOOST_TEST(paths[0].back()->getName() == "fan_out_in.a");
+  BOOST_TEST(paths[1].back()->getName() == "fan_out_in.b");
+  BOOST_TEST(paths[2].back()->getName() == "fan_out_in.c");
+  paths = np->getAllFanIn("out");
+  BOOST_TEST(paths.size() == 3);
+  BOOST_TEST(paths[0].front()->getName() == "fan_out_in.a");
+  BOOST_TEST(np->pathExists(netlist_paths::Waypoints("in", "fan_out_in.b")));
+  BOOST_TEST(!np->pathExists(netlist_paths::Waypoints("in", "out")));
+  auto path = np->getAnyPath(netlist_paths::Waypoints("fan_out_in.c", "out"));
+  BOOST_TEST(path.size() == 3);
+  BOOST_TEST(path.front()->getName() == "fan_out_in.c");
+  BOOST_TEST(path.back()->getName() == "out");
+}
+
+/// Point-to-point searches respect register traversal and avoid points.
+BOOST_FIXTURE_TEST_CASE(point_to_point, TestContext) {
+  BOOST_CHECK_NO_THROW(load("fan_out_in.xml"));
+  netlist_paths::Options::getInstance().setTraverseRegisters(true);
+  BOOST_TEST(np->pathExists(netlist_paths::Waypoints("in", "out")));
+  auto path = np->getAnyPath(netlist_paths::Waypoints("in", "out"));
+  BOOST_TEST(path.size() == 5);
+  BOOST_TEST(path.front()->getName() == "in");
+  BOOST_TEST(path.back()->getName() == "out");
+  BOOST_TEST(np->getAllPaths(netlist_paths::Waypoints("in", "out")).size() == 3);
+  netlist_paths::Waypoints waypoints("in", "out");
+  waypoints.addAvoidPoint("fan_out_in.a");
+  waypoints.addAvoidPoint("fan_out_in.b");
+  path = np->getAnyPath(waypoints);
+  BOOST_TEST(path.size() == 5);
+  BOOST_TEST(path[2]->getName() == "fan_out_in.c");
+  BOOST_TEST(np->getAllPaths(waypoints).size() == 1);
+  waypoints.addAvoidPoint("fan_out_in.c");
+  BOOST_TEST(!np->pathExists(waypoints));
+  BOOST_TEST(np->getAnyPath(waypoints).empty());
+  netlist_paths::Options::getInstance().setTraverseRegisters(false);
+}
+
+/// The reachability index answers path existence queries in the same way as
+/// searching the graph.
+BOOST_FIXTURE_TEST_CASE(reachability_index, TestContext) {
+  for (auto filename : {"assign_alias_regs.xml", "fan_out_in.xml"}) {
+    BOOST_CHECK_NO_THROW(load(filename));
+    for (auto traverseRegisters : {false, true}) {
+      netlist_paths::Options::getInstance().setTraverseRegisters(traverseRegisters);
+      std::vector<std::pair<std::string, std::string>> pairs;
+      for (auto start : np->getNamedVerticesPtr()) {
+        for (auto finish : np->getNamedVerticesPtr()) {
+          if (np->startpointExists(start->getName()) &&
+              np->endpointExists(finish->getName())) {
+            pairs.emplace_back(start->getName(), finish->getName());
+          }
+        }
+      }
+      BOOST_TEST(!pairs.empty());
+      std::vector<bool> expected;
+      for (auto &pair : pairs) {
+        expected.push_back(np->pathExists(netlist_paths::Waypoints(pair.first, pair.second)));
+      }
+      BOOST_TEST(np->buildReachabilityIndex() > 0);
+      for (std::size_t i = 0; i < pairs.size(); i++) {
+        BOOST_TEST(np->pathExists(netlist_paths::Waypoints(pairs[i].first, pairs[i].second)) == expected[i],
+                   pairs[i].first << " -> " << pairs[i].second);
+      }
+    }
+  }
+  netlist_paths::Options::getInstance().setTraverseRegisters(false);
+}
+
+/// Strongly-connected components are reported as loops, and searches through
+/// them terminate.
+BOOST_FIXTURE_TEST_CASE(comb_loop, TestContext) {
+  BOOST_CHECK_NO_THROW(load("comb_loop.xml"));
+  auto loops = np->getLoops();
+  BOOST_TEST(loops.size() == 1);
+  BOOST_TEST(loops[0].size() == 4);
+  std::vector<std::string> names;
+  for (auto vertex : loops[0]) {
+    if (!vertex->isLogic()) {
+      names.push_back(vertex->getName());
+    }
+  }
+  std::sort(names.begin(), names.end());
+  BOOST_TEST(names == std::vector<std::string>({"comb_loop.x", "comb_loop.y"}));
+  BOOST_TEST(np->pathExists(netlist_paths::Waypoints("in", "out")));
+  BOOST_TEST(np->getAnyPath(netlist_paths::Waypoints("in", "out")).size() == 7);
+  BOOST_TEST(np->getAllPaths(netlist_paths::Waypoints("in", "out")).size() == 1);
+  BOOST_TEST(np->getAllFanOut("in").size() == 2);
+  BOOST_CHECK_NO_THROW(load("fan_out_in.xml"));
+  BOOST_TEST(np->getLoops().empty());
+}
+
+/// A path enumerator produces the same paths as getAllPaths(), in the same
+/// order.
+BOOST_FIXTURE_TEST_CASE(path_enumerator, TestContext) {
+  auto checkPaths = [this](const netlist_paths::Waypoints &waypoints) {
+    auto paths = np->getAllPaths(waypoints);
+    auto enumerator = np->getPathEnumerator(waypoints);
+    std::vector<std::vector<netlist_paths::Vertex*>> enumerated;
+    for (auto &path : *enumerator) {
+      enumerated.push_back(path);
+    }
+    BOOST_TEST(!enumerator->next());
+    BOOST_TEST((enumerated == paths));
+    return paths.size();
+  };
+  BOOST_CHECK_NO_THROW(load("fan_out_in.xml"));
+  BOOST_TEST(checkPaths(netlist_paths::Waypoints("in", "out")) == 0);
+  netlist_paths::Options::getInstance().setTraverseRegisters(true);
+  BOOST_TEST(checkPaths(netlist_paths::Waypoints("in", "out")) == 3);
+  netlist_paths::Waypoints waypoints("in", "out");
+  waypoints.addThroughPoint("fan_out_in.b");
+  BOOST_TEST(checkPaths(waypoints) == 1);
+  waypoints = netlist_paths::Waypoints("in", "out");
+  waypoints.addAvoidPoint("fan_out_in.a");
+  BOOST_TEST(checkPaths(waypoints) == 2);
+  netlist_paths::Options::getInstance().setTraverseRegisters(false);
+  BOOST_CHECK_NO_THROW(load("comb_loop.xml"));
+  BOOST_TEST(checkPaths(netlist_paths::Waypoints("in", "out")) == 1);
+}
+
+/// Paths are counted without enumerating them, and the count through a loop
+/// is unbounded. Without loops in the logic, the count between every pair of
+/// connected points is the number of paths enumerated between them, even
+/// through the cycles between ports and their aliases.
+BOOST_FIXTURE_TEST_CASE(count_paths, TestContext) {
+  for (auto traverseRegisters : {false, true}) {
+    netlist_paths::Options::getInstance().setTraverseRegisters(traverseRegisters);
+    for (auto filename : {"fan_out_in.xml", "assign_alias_regs.xml"}) {
+      BOOST_CHECK_NO_THROW(load(filename));
+      BOOST_TEST(np->getLoops().empty());
+      std::size_t numConnected = 0;
+      for (auto start : np->getNamedVerticesPtr()) {
+        for (auto end : np->getNamedVerticesPtr()) {
+          netlist_paths::Waypoints waypoints(start->getName(), end->getName());
+          bool connected = false;
+          try {
+            connected = start != end && np->pathExists(waypoints);
+          } catch (const netlist_paths::Exception &) {
+            // Not a start point and an end point.
+          }
+          if (!connected) {
+            continue;
+          }
+          numConnected++;
+          BOOST_TEST_INFO(start->getName() << " -> " << end->getName());
+          BOOST_TEST(np->countPaths(waypoints) == np->getAllPaths(waypoints).size());
+        }
+      }
+      BOOST_TEST(numConnected > 0);
+    }
+  }
+  netlist_paths::Options::getInstance().setTraverseRegisters(false);
+  BOOST_CHECK_NO_THROW(load("fan_out_in.xml"));
+  BOOST_TEST(np->countPaths(netlist_paths::Waypoints("in", "out")) == 0);
+  BOOST_TEST(np->countPaths(netlist_paths::Waypoints("in", "fan_out_in.a")) == 1);
+  auto counts = np->countFanOutPaths("in");
+  BOOST_TEST(counts.size() == 3);
+  BOOST_TEST(counts[0].first->getName() == "fan_out_in.a");
+  BOOST_TEST(counts[0].second == 1);
+  counts = np->countFanInPaths("out");
+  BOOST_TEST(counts.size() == np->getAllFanIn("out").size());
+  netlist_paths::Options::getInstance().setTraverseRegisters(true);
+  for (auto avoid : {"", "fan_out_in.a"}) {
+    netlist_paths::Waypoints waypoints("in", "out");
+    if (*avoid) {
+      waypoints.addAvoidPoint(avoid);
+    }
+    BOOST_TEST(np->countPaths(waypoints) == np->getAllPaths(waypoints).size());
+  }
+  netlist_paths::Waypoints waypoints("in", "out");
+  waypoints.addThroughPoint("fan_out_in.c");
+  BOOST_TEST(np->countPaths(waypoints) == 1);
+  netlist_paths::Options::getInstance().setTraverseRegisters(false);
+  BOOST_CHECK_NO_THROW(load("comb_loop.xml"));
+  BOOST_TEST(np->countPaths(netlist_paths::Waypoints("in", "out")) == UINT64_MAX);
+}
+
+/// The rows and columns of the reachability matrix are the fan outs and fan
+/// ins of each start and end point.
+BOOST_FIXTURE_TEST_CASE(reachability_matrix, TestContext) {
+  for (auto traverseRegisters : {false, true}) {
+    netlist_paths::Options::getInstance().setTraverseRegisters(traverseRegisters);
+    for (auto filename : {"fan_out_in.xml", "comb_loop.xml", "assign_alias_regs.xml"}) {
+      BOOST_CHECK_NO_THROW(load(filename));
+      auto matrix = np->getReachabilityMatrix("", "");
+      BOOST_TEST(matrix.numStartPoints() > 0);
+      BOOST_TEST(matrix.numEndPoints() > 0);
+      std::size_t total = 0;
+      for (std::size_t i = 0; i < matrix.numStartPoints(); i++) {
+        auto start = matrix.getStartPoints()[i];
+        auto row = matrix.getRow(i);
+        total += row.size();
+        for (std::size_t j = 0; j < matrix.numEndPoints(); j++) {
+          auto end = matrix.getEndPoints()[j];
+          auto column = matrix.getColumn(j);
+          bool reaches = std::find(row.begin(), row.end(), end) != row.end();
+          BOOST_TEST(matrix.reaches(i, j) == reaches);
+          BOOST_TEST(reaches == (std::find(column.begin(), column.end(), start) != column.end()));
+        }
+      }
+      BOOST_TEST(matrix.count() == total);
+    }
+  }
+  netlist_paths::Options::getInstance().setTraverseRegisters(false);
+  BOOST_CHECK_NO_THROW(load("fan_out_in.xml"));
+  auto matrix = np->getReachabilityMatrix("in", "");
+  BOOST_TEST(matrix.numStartPoints() == 1);
+  BOOST_TEST(matrix.getRow(0).size() == np->getAllFanOut("in").size());
+  matrix = np->getReachabilityMatrix("", "out");
+  BOOST_TEST(matrix.numEndPoints() == 1);
+  BOOST_TEST(matrix.getColumn(0).size() == np->getAllFanIn("out").size());
+  BOOST_CHECK_THROW(matrix.getColumn(1), netlist_paths::Exception);
+}
+
+/// Fan out and fan in degrees are the numbers of fan out and fan in paths.
+BOOST_FIXTURE_TEST_CASE(fan_degree, TestContext) {
+  BOOST_CHECK_NO_THROW(load("fan_out_in.xml"));
+  BOOST_TEST(np->getFanOutDegree("in") == 3);
+  BOOST_TEST(np->getFanInDegree("out") == 3);
+  BOOST_TEST(np->getFanOutDegree("in") == np->getAllFanOut("in").size());
+  BOOST_TEST(np->getFanInDegree("out") == np->getAllFanIn("out").size());
+  BOOST_CHECK_THROW(np->getFanOutDegree("foo"), netlist_paths::Exception);
+  BOOST_CHECK_THROW(np->getFanInDegree("foo"), netlist_paths::Exception);
+  BOOST_CHECK_NO_THROW(load("comb_loop.xml"));
+  BOOST_TEST(np->getFanOutDegree("in") == np->getAllFanOut("in").size());
+}
+
+/// A missing netlist file is reported as an error rather than parsed.
+BOOST_FIXTURE_TEST_CASE(missing_file, TestContext) {
+  BOOST_CHECK_THROW(load("missing_file.xml"), netlist_paths::Exception);
+}
+
+/// Streaming the XML produces the same netlist as parsing the whole document.
+BOOST_FIXTURE_TEST_CASE(stream_xml, TestContext) {
+  BOOST_CHECK_NO_THROW(load("assign_alias_regs.xml"));
+  auto numVertices = np->getNamedVertices().size();
+  netlist_paths::Options::getInstance().setStreamXML(true);
+  BOOST_CHECK_NO_THROW(load("assign_alias_regs.xml"));
+  netlist_paths::Options::getInstance().setStreamXML(false);
+  BOOST_TEST(np->getNamedVertices().size() == numVertices);
+  BOOST_TEST(np->regExists("assign_alias_regs.sum.add.register_q"));
+  BOOST_TEST(np->regExists("assign_alias_regs.__Vcellout__sum.add__register_q"));
+  BOOST_TEST(np->getVertexDTypeWidth("assign_alias_regs.sum.add.register_q") > 0);
+}
+
+/// Building the graph with several threads produces the same netlist as
+/// building it with one.
+BOOST_FIXTURE_TEST_CASE(parallel_build, TestContext) {
+  auto describe = [this]() {
+    std::vector<std::string> result;
+    for (auto vertex : np->getNamedVerticesPtr()) {
+      result.push_back(vertex->toString() + " " + vertex->getDTypeStr());
+    }
+    for (auto vertex : np->getRegVerticesPtr()) {
+      result.push_back(vertex->getName() + " " +
+                       std::to_string(np->getAllFanOut(vertex->getName()).size()));
+    }
+    return result;
+  };
+  // Variables and data types can also be declared within statements.
+  for (auto filename : {"assign_alias_regs.xml", "nested_vars.xml", "nested_dtypes.xml"}) {
+    BOOST_CHECK_NO_THROW(load(filename));
+    auto serial = describe();
+    netlist_paths::Options::getInstance().setNumJobs(4);
+    BOOST_CHECK_NO_THROW(load(filename));
+    netlist_paths::Options::getInstance().setNumJobs(1);
+    BOOST_TEST(describe() == serial, boost::test_tools::per_element());
+  }
+  BOOST_TEST(np->getVertexDTypeStr("nested_dtypes.d") == "logic");
+}
+
+/// Exact name lookups find every named vertex.
+BOOST_FIXTURE_TEST_CASE(name_index, TestContext) {
+  BOOST_CHECK_NO_THROW(load("assign_alias_regs.xml"));
+  for (auto vertex : np->getNamedVerticesPtr()) {
+    auto matches = np->getNamedVerticesPtr(vertex->getName());
+    BOOST_TEST(matches.size() == 1);
+    BOOST_TEST(matches.front()->getName() == vertex->getName());
+  }
+  for (auto vertex : np->getRegVerticesPtr()) {
+    BOOST_TEST(np->regExists(vertex->getName()));
+  }
+  BOOST_TEST(np->getNamedVerticesPtr("assign_alias_regs.foo").empty());
+  BOOST_TEST(!np->regExists("assign_alias_regs"));
+}
+
+/// Wildcard patterns with a literal prefix are matched against the names in
+/// the index with that prefix, and scopes list the names within them.
+BOOST_FIXTURE_TEST_CASE(name_scopes, TestContext) {
+  BOOST_CHECK_NO_THROW(load("fan_out_in.xml"));
+  netlist_paths::Options::getInstance().setMatchWildcard();
+  auto names = [](const std::vector<netlist_paths::Vertex*> &vertices) {
+    std::vector<std::string> result;
+    for (auto vertex : vertices) {
+      result.push_back(vertex->getName());
+    }
+    return result;
+  };
+  std::vector<std::string> scoped = {"fan_out_in.in", "fan_out_in.out", "fan_out_in.a",
+                                     "fan_out_in.b", "fan_out_in.c"};
+  auto vertices = np->getNamedVerticesPtr("fan_out_in.*");
+  BOOST_TEST(names(vertices) == scoped, boost::test_tools::per_element());
+  BOOST_TEST(names(np->getVerticesUnderScope("fan_out_in")) == scoped,
+             boost::test_tools::per_element());
+  BOOST_TEST(np->getNamedVerticesPtr("fan_out_in.?").size() == 3);
+  BOOST_TEST(np->getNamedVerticesPtr("*.?").size() == 3);
+  BOOST_TEST(np->getNamedVerticesPtr("fan_out").empty());
+  BOOST_TEST(np->getVerticesUnderScope("fan_out").empty());
+  BOOST_TEST(np->getVerticesUnderScope("").size() == np->getNamedVerticesPtr().size());
+  netlist_paths::Options::getInstance().setIgnoreHierarchyMarkers(true);
+  BOOST_TEST(np->getNamedVerticesPtr("fan_out_in.a").size() == 1);
+  netlist_paths::Options::getInstance().setIgnoreHierarchyMarkers(false);
+  netlist_paths::Options::getInstance().setMatchExact();
+}
+
+/// Both regex engines match the same names.
+BOOST_FIXTURE_TEST_CASE(regex_engines, TestContext) {
+  BOOST_CHECK_NO_THROW(load("fan_out_in.xml"));
+  netlist_paths::Options::getInstance().setMatchRegex();
+  for (auto pattern : {"fan_out_in", "fan_out_in\\.[abc]", "^in$", "out", "o?ut",
+                       "fan_.*_in\\.(in|out)", "[a-z]+\\.b", "[[:alpha:]_]+\\.[[:alpha:]]"}) {
+    netlist_paths::Options::getInstance().setRegexEngineStd();
+    auto expected = np->getNamedVerticesPtr(pattern);
+    netlist_paths::Options::getInstance().setRegexEngineBoost();
+    BOOST_TEST(np->getNamedVerticesPtr(pattern) == expected, boost::test_tools::per_element());
+  }
+  BOOST_TEST(np->getNamedVerticesPtr("fan_out_in\\.[abc]").size() == 3);
+  BOOST_TEST(np->getNamedVerticesPtr("fan_out_in\\.[[:alpha:]]$").size() == 3);
+  BOOST_CHECK_THROW(np->getNamedVerticesPtr("fan_out_in["), netlist_paths::Exception);
+  netlist_paths::Options::getInstance().setRegexEngineStd();
+  BOOST_CHECK_THROW(np->getNamedVerticesPtr("fan_out_in["), netlist_paths::Exception);
+  netlist_paths::Options::getInstance().setMatchExact();
+}
+
+/// A netlist loaded from a snapshot is the same as the one that was saved.
+BOOST_FIXTURE_TEST_CASE(snapshot, TestContext) {
+  auto describe = [this]() {
+    std::vector<std::string> result;
+    for (auto vertex : np->getNamedVerticesPtr()) {
+      result.push_back(vertex->getName() + " " + vertex->getAstTypeStr() + " " +
+                       vertex->getDTypeStr() + " " + np->getLocationStr(vertex));
+    }
+    for (auto vertex : np->getRegVerticesPtr()) {
+      for (auto &path : np->getAllFanOut(vertex->getName())) {
+        result.push_back(vertex->getName() + " -> " + path.back()->getName());
+      }
+    }
+    return result;
+  };
+  BOOST_CHECK_NO_THROW(load("assign_alias_regs.xml"));
+  auto snapshotPath = fs::unique_path();
+  np->save(snapshotPath.native());
+  auto expected = describe();
+  np = netlist_paths::Netlist::load(snapshotPath.native());
+  BOOST_TEST(describe() == expected, boost::test_tools::per_element());
+  // A corrupted snapshot is rejected.
+  {
+    std::fstream snapshotFile(snapshotPath.native(),
+                              std::ios::in | std::ios::out | std::ios::binary);
+    snapshotFile.seekp(-1, std::ios::end);
+    snapshotFile.put('\xff');
+  }
+  BOOST_CHECK_THROW(netlist_paths::Netlist::load(snapshotPath.native()),
+                    netlist_paths::Exception);
+  fs::remove(snapshotPath);
+  // XML is not a snapshot.
+  BOOST_CHECK_THROW(netlist_paths::Netlist::load((fs::path(xmlPrefix) / "assign_alias_regs.xml").string()),
+                    netlist_paths::Exception);
+}
+
+/// A netlist image answers queries in the same way as the netlist it was
+/// written from.
+BOOST_FIXTURE_TEST_CASE(image, TestContext) {
+  auto describe = [this]() {
+    std::vector<std::string> result;
+    for (auto vertex : np->getNamedVerticesPtr()) {
+      result.push_back(vertex->getName() + " " + vertex->getAstTypeStr() + " " +
+                       vertex->getDTypeStr() + " " + np->getLocationStr(vertex));
+    }
+    for (auto vertex : np->getRegVerticesPtr()) {
+      for (auto &path : np->getAllFanOut(vertex->getName())) {
+        std::string pathStr;
+        for (auto pathVertex : path) {
+          pathStr += " " + pathVertex->getName();
+        }
+        result.push_back(vertex->getName() + " ->" + pathStr);
+      }
+    }
+    for (auto vertex : np->getPortVerticesPtr()) {
+      if (vertex->isEndPoint()) {
+        result.push_back(vertex->getName() + " <- " +
+                         std::to_string(np->getAllFanIn(vertex->getName()).size()));
+      }
+      if (vertex->isStartPoint()) {
+        result.push_back(vertex->getName() + " -> " +
+                         std::to_string(np->getAllFanOut(vertex->getName()).size()));
+      }
+    }
+    result.push_back(std::to_string(np->regExists("assign_alias_regs.sum.add.register_q")));
+    return result;
+  };
+  auto imagePath = fs::unique_path();
+  for (auto filename : {"assign_alias_regs.xml", "fan_out_in.xml"}) {
+    BOOST_CHECK_NO_THROW(load(filename));
+    np->saveImage(imagePath.native());
+    auto expected = describe();
+    np = netlist_paths::Netlist::openImage(imagePath.native());
+    BOOST_TEST(describe() == expected, boost::test_tools::per_element());
+  }
+  // An image cannot be saved.
+  BOOST_CHECK_THROW(np->saveImage(imagePath.native()), netlist_paths::Exception);
+  np.reset();
+  // A truncated image is rejected.
+  fs::resize_file(imagePath, fs::file_size(imagePath) - 1);
+  BOOST_CHECK_THROW(netlist_paths::Netlist::openImage(imagePath.native()),
+                    netlist_paths::Exception);
+  fs::remove(imagePath);
+  // XML is not an image.
+  BOOST_CHECK_THROW(netlist_paths::Netlist::openImage((fs::path(xmlPrefix) / "assign_alias_regs.xml").string()),
+                    netlist_paths::Exception);
+}
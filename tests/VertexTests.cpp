@@ -75,3 +75,17 @@ BOOST_FIXTURE_TEST_CASE(port_register_nested, TestContext) {
   BOOST_TEST(np->getNetVerticesPtr("i_").size() == 2);
   BOOST_TEST(np->getNetVerticesPtr("o_").size() == 1);
 }
+
+//===----------------------------------------------------------------------===//
+// Test vertex locations, which refer to source files by their index.
+//===----------------------------------------------------------------------===//
+
+BOOST_AUTO_TEST_CASE(location_file_index) {
+  std::vector<File> files = {File("other.sv", "1800-2017"),
+                             File("location.sv", "1800-2017")};
+  auto location = Location(1, 1, 2, 3, 4);
+  BOOST_TEST(location.getLocationStr(files) == "location.sv:1");
+  BOOST_TEST(location.getLocationStrExact(files) == "location.sv 1:2,3:4");
+  BOOST_TEST(Location().getLocationStr(files) == "unknown:0");
+  BOOST_TEST(Location(2, 1, 2, 3, 4).getLocationStr(files) == "unknown:1");
+}
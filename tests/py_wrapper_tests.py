@@ -134,6 +134,19 @@ class TestPyWrapper(unittest.TestCase):
         self.assertTrue(np.any_reg_exists('pipeline_module.g_pipestage\[.\].u_pipestage.data_q'))
         self.assertTrue(np.any_reg_exists('pipeline_module..*.u_pipestage.data_q'))
 
+    def test_vertices_under_scope(self):
+        """
+        Test listing the vertices in a scope of the hierarchy.
+        """
+        np = self.compile_test('pipeline_module.sv')
+        scope = 'pipeline_module.g_pipestage[0].u_pipestage'
+        names = [v.get_name() for v in np.get_vertices_under_scope(scope)]
+        self.assertIn(scope+'.data_q', names)
+        self.assertTrue(all(name.startswith(scope+'.') for name in names))
+        Options.get_instance().set_match_wildcard()
+        self.assertEqual(names,
+                         [v.get_name() for v in np.get_named_vertices(scope+'.*')])
+
     def test_path_any_to_any(self):
         """
         Test querying of any paths.
@@ -171,6 +184,115 @@ class TestPyWrapper(unittest.TestCase):
         paths = np.get_all_fanin_paths('out')
         self.assertTrue(len(paths) == 3)
 
+    def test_location_str(self):
+        """
+        Check vertex locations are the same from the vertex and the netlist.
+        """
+        np = self.compile_test('fan_out_in.sv')
+        for vertex in np.get_named_vertices():
+            self.assertIn('fan_out_in.sv:', vertex.get_location_str())
+            self.assertEqual(vertex.get_location_str(), np.get_location_str(vertex))
+        np.save_image('netlist.image')
+        image = Netlist.open_image('netlist.image')
+        for vertex in image.get_named_vertices():
+            self.assertEqual(vertex.get_location_str(), image.get_location_str(vertex))
+        del image
+        os.remove('netlist.image')
+
+    def test_snapshot(self):
+        """
+        Test saving and loading a netlist snapshot.
+        """
+        np = self.compile_test('fan_out_in.sv')
+        np.save('netlist.snapshot')
+        snapshot = Netlist.load('netlist.snapshot')
+        self.assertEqual([v.get_name() for v in snapshot.get_named_vertices()],
+                         [v.get_name() for v in np.get_named_vertices()])
+        self.assertTrue(len(snapshot.get_all_fanout_paths('in')) == 3)
+        os.remove('netlist.snapshot')
+
+    def test_image(self):
+        """
+        Test saving and opening a netlist image.
+        """
+        np = self.compile_test('fan_out_in.sv')
+        np.save_image('netlist.image')
+        image = Netlist.open_image('netlist.image')
+        self.assertEqual([v.get_name() for v in image.get_named_vertices()],
+                         [v.get_name() for v in np.get_named_vertices()])
+        self.assertTrue(len(image.get_all_fanout_paths('in')) == 3)
+        self.assertTrue(len(image.get_all_fanin_paths('out')) == 3)
+        del image
+        os.remove('netlist.image')
+
+    def test_reachability_index(self):
+        """
+        Test path existence queries with a reachability index.
+        """
+        np = self.compile_test('fan_out_in.sv')
+        self.assertTrue(np.build_reachability_index() > 0)
+        self.assertTrue(np.path_exists(Waypoints('in', 'fan_out_in.a')))
+        self.assertFalse(np.path_exists(Waypoints('in', 'out')))
+
+    def test_iter_paths(self):
+        """
+        Test enumeration of paths one at a time.
+        """
+        np = self.compile_test('multiple_paths.sv')
+        paths = np.get_all_paths(Waypoints('in', 'out'))
+        iter_paths = list(np.iter_paths(Waypoints('in', 'out')))
+        self.assertTrue(len(paths) > 1)
+        self.assertEqual(len(iter_paths), len(paths))
+        for path, iter_path in zip(paths, iter_paths):
+            self.assertEqual([v.get_name() for v in path],
+                             [v.get_name() for v in iter_path])
+
+    def test_count_paths(self):
+        """
+        Test counting of paths without enumerating them.
+        """
+        np = self.compile_test('multiple_paths.sv')
+        self.assertEqual(np.count_paths(Waypoints('in', 'out')),
+                         len(np.get_all_paths(Waypoints('in', 'out'))))
+        counts = np.count_fanout_paths('in')
+        self.assertTrue(len(counts) > 0)
+        self.assertTrue(all(count > 0 for _, count in counts))
+
+    def test_reachability_matrix(self):
+        """
+        Test the rows of the reachability matrix are the fan outs of the
+        start points.
+        """
+        np = self.compile_test('multiple_paths.sv')
+        matrix = np.get_reachability_matrix('', '')
+        self.assertTrue(matrix.num_start_points() > 0)
+        for i, start in enumerate(matrix.get_start_points()):
+            fan_out = [path[-1].get_name() for path in np.get_all_fanout_paths(start.get_name())]
+            self.assertEqual(sorted(v.get_name() for v in matrix.get_row(i)),
+                             sorted(fan_out))
+
+    def test_fan_degree(self):
+        """
+        Test the fan out and fan in degrees match the numbers of paths.
+        """
+        np = self.compile_test('counter.sv')
+        self.assertEqual(np.get_fanout_degree('counter.counter_q'),
+                         len(np.get_all_fanout_paths('counter.counter_q')))
+        self.assertEqual(np.get_fanin_degree('counter.counter_q'),
+                         len(np.get_all_fanin_paths('counter.counter_q')))
+
+    def test_loops(self):
+        """
+        Test reporting of loops, which only pass through registers.
+        """
+        np = self.compile_test('pipeline_loops.sv')
+        self.assertEqual(len(np.get_loops()), 0)
+        Options.get_instance().set_traverse_registers(True)
+        loops = np.get_loops()
+        self.assertTrue(len(loops) > 0)
+        self.assertTrue(any(v.get_name() == 'pipeline_loops.data_q' for v in loops[0]))
+        Options.get_instance().set_traverse_registers(False)
+
     def test_any_start_finish_points(self):
         """
         Test matching of distinct paths through common mid points.
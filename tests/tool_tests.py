@@ -80,6 +80,54 @@ class TestTool(unittest.TestCase):
         returncode, _ = self.run_np(['--compile', test_path, '--to', 'counter.counter_q'])
         self.assertEqual(returncode, 0)
 
+    def test_count_paths(self):
+        test_path = os.path.join(defs.TEST_SRC_PREFIX, 'multiple_paths.sv')
+        returncode, stdout = self.run_np(['--compile', test_path, '--from', 'in', '--to', 'out', '--count-paths'])
+        self.assertEqual(returncode, 0)
+        self.assertTrue(int(stdout) > 1)
+
+    def test_fan_degree(self):
+        test_path = os.path.join(defs.TEST_SRC_PREFIX, 'counter.sv')
+        returncode, stdout = self.run_np(['--compile', test_path, '--from', 'counter.counter_q', '--fanout'])
+        self.assertEqual(returncode, 0)
+        self.assertTrue(int(stdout) > 0)
+        returncode, stdout = self.run_np(['--compile', test_path, '--to', 'counter.counter_q', '--fanin'])
+        self.assertEqual(returncode, 0)
+        self.assertTrue(int(stdout) > 0)
+
+    def test_loops(self):
+        test_path = os.path.join(defs.TEST_SRC_PREFIX, 'pipeline_loops.sv')
+        returncode, stdout = self.run_np(['--compile', test_path, '--loops'])
+        self.assertEqual(returncode, 0)
+        self.assertNotIn('Loop 0', stdout)
+        returncode, stdout = self.run_np(['--compile', test_path, '--loops', '--traverse-registers'])
+        self.assertEqual(returncode, 0)
+        self.assertIn('Loop 0', stdout)
+
+
+    def test_snapshot(self):
+        test_path = os.path.join(defs.TEST_SRC_PREFIX, 'counter.sv')
+        snapshot_path = os.path.join(defs.CURRENT_BINARY_DIR, 'counter.snapshot')
+        returncode, xml_stdout = self.run_np(['--compile', test_path, '--dump-names',
+                                              '--save-snapshot', snapshot_path])
+        self.assertEqual(returncode, 0)
+        self.assertTrue(os.path.exists(snapshot_path))
+        returncode, snapshot_stdout = self.run_np(['--snapshot', snapshot_path, '--dump-names'])
+        self.assertEqual(returncode, 0)
+        self.assertEqual(snapshot_stdout, xml_stdout)
+        os.remove(snapshot_path)
+
+    def test_image(self):
+        test_path = os.path.join(defs.TEST_SRC_PREFIX, 'counter.sv')
+        image_path = os.path.join(defs.CURRENT_BINARY_DIR, 'counter.image')
+        returncode, xml_stdout = self.run_np(['--compile', test_path, '--dump-names',
+                                              '--save-image', image_path])
+        self.assertEqual(returncode, 0)
+        self.assertTrue(os.path.exists(image_path))
+        returncode, image_stdout = self.run_np(['--image', image_path, '--dump-names'])
+        self.assertEqual(returncode, 0)
+        self.assertEqual(image_stdout, xml_stdout)
+        os.remove(image_path)
 
 if __name__ == '__main__':
     unittest.main()
@@ -0,0 +1,14 @@
+module comb_loop
+  (
+    input  logic in,
+    output logic out
+  );
+
+  logic x;
+  logic y;
+
+  assign x = in & y;
+  assign y = x;
+  assign out = y;
+
+endmodule
@@ -2,6 +2,7 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 #include <boost/filesystem.hpp>
@@ -26,11 +27,16 @@ int main(int argc, char **argv) {
     std::string startName;
     std::string endName;
     std::string nameRegex;
+    std::string snapshotFilename;
+    std::string saveSnapshotFilename;
+    std::string imageFilename;
+    std::string saveImageFilename;
     std::vector<std::string> throughNames;
+    size_t numJobs;
     // Specify command line options.
     hiddenOptions.add_options()
       ("input-file",
-       po::value<std::vector<std::string>>(&inputFiles)->required());
+       po::value<std::vector<std::string>>(&inputFiles));
     p.add("input-file", -1);
     genericOptions.add_options()
       ("help,h",        "Display help")
@@ -47,8 +53,8 @@ int main(int argc, char **argv) {
       ("allpaths",      "Find all paths between two points (exponential time)")
       ("startpoints",   "Only report start points")
       ("endpoints",     "Only report end points")
-      ("fanout",        "Determine the fan out degree to bit end points")
-      ("fanin",         "Determine the fan in degree from bit start points")
+      ("fanout",        "Determine the fan out degree to end points (with --from)")
+      ("fanin",         "Determine the fan in degree from start points (with --to)")
       ("reportlogic",   "Display logic in path report")
       ("filenames",     "Display full filenames in path report")
       ("compile",       "Compile a netlist graph from Verilog source")
@@ -62,6 +68,7 @@ int main(int argc, char **argv) {
                         "define a preprocessor macro (only with --compile)")
       ("dotfile",       "Dump dotfile of netlist graph")
       ("dump-names",    "Dump list of names in netlist")
+      ("loops",         "Report the combinational loops in the netlist")
       ("match",         po::value<std::string>(&nameRegex)
                           ->value_name("name regex"),
                         "Regex to match names against (only with --dump-names)")
@@ -70,6 +77,22 @@ int main(int argc, char **argv) {
                           ->value_name("filename"),
                         "output file")
       ("boostparser",   "Use the boost GraphViz parser")
+      ("snapshot",      po::value<std::string>(&snapshotFilename)
+                          ->value_name("filename"),
+                        "Load the netlist from a snapshot instead of XML")
+      ("save-snapshot", po::value<std::string>(&saveSnapshotFilename)
+                          ->value_name("filename"),
+                        "Save the netlist to a snapshot file")
+      ("image",         po::value<std::string>(&imageFilename)
+                          ->value_name("filename"),
+                        "Query a netlist image instead of XML")
+      ("save-image",    po::value<std::string>(&saveImageFilename)
+                          ->value_name("filename"),
+                        "Save the netlist to an image file")
+      ("jobs,j",        po::value<size_t>(&numJobs)
+                          ->default_value(1)
+                          ->value_name("number"),
+                        "Number of threads to build the netlist graph with")
       ("verbose,v",     "Print information")
       ("debug,d",       "Print debugging information");
     allOptions.add(genericOptions).add(hiddenOptions);
@@ -86,9 +109,10 @@ int main(int argc, char **argv) {
     bool displayHelp   = vm.count("help") > 0;
     bool compile       = vm.count("compile") > 0;
     bool dumpNames     = vm.count("dumpnames") > 0;
+    bool reportLoops   = vm.count("loops") > 0;
+    bool fanOutDegree  = vm.count("fanout") > 0;
+    bool fanInDegree   = vm.count("fanin") > 0;
     //netlist_paths::Options::getInstance().dumpDotfile   = vm.count("dotfile") > 0;
-    //netlist_paths::Options::getInstance().fanOutDegree  = vm.count("fanout") > 0;
-    //netlist_paths::Options::getInstance().fanInDegree   = vm.count("fanin") > 0;
     //netlist_paths::Options::getInstance().allPaths      = vm.count("allpaths") > 0;
     //netlist_paths::Options::getInstance().startPoints   = vm.count("startpoints") > 0;
     //netlist_paths::Options::getInstance().endPoints     = vm.count("endpoints") > 0;
@@ -103,6 +127,9 @@ int main(int argc, char **argv) {
       return 1;
     }
     notify(vm);
+    if (inputFiles.empty() && snapshotFilename.empty() && imageFilename.empty()) {
+      throw netlist_paths::Exception("no input file specified");
+    }
 
     // Call Verilator to produce graph file.
     if (compile) {
@@ -122,11 +149,34 @@ int main(int argc, char **argv) {
                               outputFilename);
     }
 
-    // Parse the input file.
-    if (inputFiles.size() > 1) {
-      throw netlist_paths::Exception("multiple XML files specified");
+    // Parse the input file, or load a snapshot or image.
+    netlist_paths::Options::getInstance().setNumJobs(numJobs);
+    std::unique_ptr<netlist_paths::Netlist> netlistPaths;
+    if (!snapshotFilename.empty() && !imageFilename.empty()) {
+      throw netlist_paths::Exception("snapshot specified with an image");
+    }
+    if (!snapshotFilename.empty()) {
+      if (!inputFiles.empty()) {
+        throw netlist_paths::Exception("XML file specified with a snapshot");
+      }
+      netlistPaths = netlist_paths::Netlist::load(snapshotFilename);
+    } else if (!imageFilename.empty()) {
+      if (!inputFiles.empty()) {
+        throw netlist_paths::Exception("XML file specified with an image");
+      }
+      netlistPaths = netlist_paths::Netlist::openImage(imageFilename);
+    } else {
+      if (inputFiles.size() > 1) {
+        throw netlist_paths::Exception("multiple XML files specified");
+      }
+      netlistPaths = std::make_unique<netlist_paths::Netlist>(inputFiles.front());
+    }
+    if (!saveSnapshotFilename.empty()) {
+      netlistPaths->save(saveSnapshotFilename);
+    }
+    if (!saveImageFilename.empty()) {
+      netlistPaths->saveImage(saveImageFilename);
     }
-    auto netlistPaths = netlist_paths::Netlist(inputFiles.front());
 //
 //    // Dump dot file.
 //    if (netlist_paths::Options::getInstance().dumpDotfile) {
@@ -139,7 +189,42 @@ int main(int argc, char **argv) {
 //
     // Dump netlist names.
     if (dumpNames) {
-      std::cout << "Netlist empty? " << netlistPaths.isEmpty() << "\n";
+      std::cout << "Netlist empty? " << netlistPaths->isEmpty() << "\n";
+      return 0;
+    }
+
+    // Report combinational loops.
+    if (reportLoops) {
+      auto loops = netlistPaths->getLoops();
+      for (size_t i = 0; i < loops.size(); i++) {
+        std::cout << "Loop " << i << "\n";
+        for (auto vertex : loops[i]) {
+          std::cout << "  " << std::left << std::setw(40)
+                    << (vertex->isLogic() ? vertex->getSimpleAstTypeStr() : vertex->getName())
+                    << " " << netlistPaths->getLocationStr(vertex) << "\n";
+        }
+      }
+      if (loops.empty()) {
+        std::cout << "No loops.\n";
+      }
+      return 0;
+    }
+
+    // Report the fan out degree from startName.
+    if (fanOutDegree) {
+      if (startName.empty()) {
+        throw netlist_paths::Exception("no start point specified for fan out degree");
+      }
+      std::cout << netlistPaths->getFanOutDegree(startName) << "\n";
+      return 0;
+    }
+
+    // Report the fan in degree to endName.
+    if (fanInDegree) {
+      if (endName.empty()) {
+        throw netlist_paths::Exception("no end point specified for fan in degree");
+      }
+      std::cout << netlistPaths->getFanInDegree(endName) << "\n";
       return 0;
     }
 
@@ -155,11 +240,7 @@ int main(int argc, char **argv) {
 //      if (!throughNames.empty()) {
 //        throw netlist_paths::Exception("through points not supported for start only");
 //      }
-//      if (netlist_paths::options.fanOutDegree) {
-//        // Report the fan out degree from startName.
-//        std::cout << netlist.getfanOutDegree(startName) << "\n";
-//        return 0;
-//      } else if (netlist_paths::options.endPoints) {
+//      if (netlist_paths::options.endPoints) {
 //        // Report the end points.
 //        auto paths = netlist.getAllFanOut(startName);
 //        netlist_paths::Path fanOutEndPoints;
@@ -179,11 +260,7 @@ int main(int argc, char **argv) {
 //    if (startName.empty() && !endName.empty()) {
 //      if (!throughNames.empty())
 //        throw netlist_paths::Exception("through points not supported for end only");
-//      if (netlist_paths::options.fanInDegree) {
-//        // Report the fan in degree to endName.
-//        std::cout << netlist.getFanInDegree(endName) << "\n";
-//        return 0;
-//      } else if (netlist_paths::options.startPoints) {
+//      if (netlist_paths::options.startPoints) {
 //        // Report the start points.
 //        auto paths = netlist.getAllFanIn(endName);
 //        for (auto &path : paths) {
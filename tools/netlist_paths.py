@@ -11,6 +11,7 @@ from py_netlist_paths import RunVerilator, Netlist, Waypoints, Options
 
 
 DEFAULT_DOT_FILE = 'graph.dot'
+MAX_PATH_COUNT = 2**64 - 1
 
 def write_table(rows, fd):
     """
@@ -27,7 +28,7 @@ def write_table(rows, fd):
     for row in rows[1:]:
         fd.write(fmt.format(row=row, widths=widths))
 
-def dump_names(vertices, fd):
+def dump_names(netlist, vertices, fd):
     """
     Dump a table of names and their attributes matching regex to fd.
     """
@@ -39,14 +40,14 @@ def dump_names(vertices, fd):
                                                x.get_dtype_str(),
                                                x.get_dtype_width(),
                                                x.get_direction_str(),
-                                               x.get_location_str()))
+                                               netlist.get_location_str(x)))
     for vertex in vertices:
         rows.append((vertex.get_name(),
                      vertex.get_ast_type_str(),
                      vertex.get_dtype_str(),
                      str(vertex.get_dtype_width()),
                      vertex.get_direction_str(),
-                     vertex.get_location_str()))
+                     netlist.get_location_str(vertex)))
     if len(vertices) > 0:
         # Write the table out.
         write_table(rows, fd)
@@ -67,7 +68,7 @@ def dump_path_report(netlist, path, fd):
             not path[index].is_logic() and \
             path[index+1].is_logic():
             row = (path[index].get_name(), path[index].get_ast_type_str(), path[index].get_dtype_str(),
-                   path[index+1].get_ast_type_str(), path[index+1].get_location_str())
+                   path[index+1].get_ast_type_str(), netlist.get_location_str(path[index+1]))
             index += 2
         # Var reference only.
         elif not path[index].is_logic():
@@ -75,7 +76,7 @@ def dump_path_report(netlist, path, fd):
             index += 1
         # Statement only.
         else:
-            row = ('', '', '', path[index].get_ast_type_str(), path[index].get_location_str())
+            row = ('', '', '', path[index].get_ast_type_str(), netlist.get_location_str(path[index]))
             index += 1
         rows.append(row)
     if len(rows) > 1:
@@ -86,19 +87,54 @@ def dump_path_report(netlist, path, fd):
 
 def dump_path_list_report(netlist, paths, fd):
     """
-    Report a list of paths.
+    Report a list of paths, or the paths produced by an iterator.
     """
-    if len(paths) == 0:
-        print('No matching paths.')
-        return
+    num_paths = 0
     for i, path in enumerate(paths):
         fd.write('\nPath {}\n'.format(i))
         dump_path_report(netlist, path, fd)
+        num_paths += 1
+    if num_paths == 0:
+        print('No matching paths.')
+
+def format_path_count(count):
+    """
+    Format a path count, which saturates when there are too many to count.
+    """
+    return 'unbounded' if count == MAX_PATH_COUNT else str(count)
+
+def dump_path_count_report(counts, fd):
+    """
+    Report the number of paths to or from each of a list of points.
+    """
+    if len(counts) == 0:
+        print('No matching paths.')
+        return
+    rows = [('Name', 'Paths')]
+    for vertex, count in counts:
+        rows.append((vertex.get_name(), format_path_count(count)))
+    write_table(rows, fd)
+
+def dump_loop_report(netlist, loops, fd):
+    """
+    Report the vertices of each loop.
+    """
+    if len(loops) == 0:
+        print('No loops.')
+        return
+    for i, loop in enumerate(loops):
+        fd.write('\nLoop {}\n'.format(i))
+        rows = [('Name', 'Type', 'Location')]
+        for vertex in loop:
+            rows.append((vertex.get_name(),
+                         vertex.get_ast_type_str(),
+                         netlist.get_location_str(vertex)))
+        write_table(rows, fd)
 
 def main():
     parser = argparse.ArgumentParser(description="Query a Verilog netlist")
     parser.add_argument('files',
-                        nargs='+',
+                        nargs='*',
                         help='Input files')
     parser.add_argument('-c', '--compile',
                         action='store_true',
@@ -141,6 +177,9 @@ def main():
     parser.add_argument('--dump-dot',
                         action='store_true',
                         help='Dump a dotfile of the netlist\'s graph')
+    parser.add_argument('--loops',
+                        action='store_true',
+                        help='Report the loops in the netlist (combinational unless traversing registers)')
     parser.add_argument('--from',
                         dest='start_point',
                         metavar='point',
@@ -179,11 +218,25 @@ def main():
     parser.add_argument('--all-paths',
                         action='store_true',
                         help='Find all paths between two points (exponential time)')
+    parser.add_argument('--count-paths',
+                        action='store_true',
+                        help='Count the paths instead of reporting them (linear time)')
+    parser.add_argument('--fanout',
+                        action='store_true',
+                        help='Report the number of end points in the fan out of a start point')
+    parser.add_argument('--fanin',
+                        action='store_true',
+                        help='Report the number of start points in the fan in of an end point')
     parser.add_argument('--regex',
                         action='store_const',
                         const=lambda: Options.get_instance().set_match_regex(),
                         default=lambda *args: None,
                         help='Enable regular expression matching of names')
+    parser.add_argument('--boost-regex',
+                        action='store_const',
+                        const=lambda: Options.get_instance().set_regex_engine_boost(),
+                        default=lambda *args: None,
+                        help='Match regular expressions with Boost.Regex, which is faster')
     parser.add_argument('--wildcard',
                         action='store_const',
                         const=lambda: Options.get_instance().set_match_wildcard(),
@@ -194,6 +247,32 @@ def main():
                         const=lambda: Options.ignore_hierarchy_markers(),
                         default=lambda *args: None,
                         help='Ignore hierarchy markers: _ . /')
+    parser.add_argument('--stream-xml',
+                        action='store_const',
+                        const=lambda: Options.get_instance().set_stream_xml(True),
+                        default=lambda *args: None,
+                        help='Read the XML netlist incrementally to reduce memory usage '
+                             '(with a single thread)')
+    parser.add_argument('--snapshot',
+                        default=None,
+                        metavar='file',
+                        help='Load the netlist from a snapshot instead of XML')
+    parser.add_argument('--save-snapshot',
+                        default=None,
+                        metavar='file',
+                        help='Save the netlist to a snapshot file')
+    parser.add_argument('--image',
+                        default=None,
+                        metavar='file',
+                        help='Query a netlist image instead of XML')
+    parser.add_argument('--save-image',
+                        default=None,
+                        metavar='file',
+                        help='Save the netlist to an image file')
+    parser.add_argument('-j', '--jobs',
+                        type=int,
+                        default=1,
+                        help='Number of threads to build and search the netlist graph with')
     parser.add_argument('-v', '--verbose',
                         action='store_const',
                         const=lambda: Options.get_instance().set_verbose(),
@@ -209,55 +288,81 @@ def main():
     # Setup options.
     args.traverse_registers()
     args.regex()
+    args.boost_regex()
     args.wildcard()
     args.ignore_hierarchy_markers()
     args.start_anywhere()
     args.end_anywhere()
+    args.stream_xml()
+    Options.get_instance().set_num_jobs(args.jobs)
     args.verbose()
     args.debug()
 
     try:
 
-        # Verilator compilation
-        # (Only supports one source file currently, useful for testing.)
-        if args.compile:
-            if args.output_file == None:
-                output_filename = next(tempfile._get_candidate_names())
-            else:
-                output_filename = args.output_file
-            comp = RunVerilator(defs.INSTALL_PREFIX)
-            if comp.run(args.files[0], output_filename) > 0:
-                raise RuntimeError('error compiling design')
+        if args.snapshot and args.image:
+            raise RuntimeError('cannot specify a snapshot with an image')
+        if args.snapshot:
+            if len(args.files) > 0:
+                raise RuntimeError('cannot specify netlist XML files with a snapshot')
+            netlist = Netlist.load(args.snapshot)
+        elif args.image:
+            if len(args.files) > 0:
+                raise RuntimeError('cannot specify netlist XML files with an image')
+            netlist = Netlist.open_image(args.image)
         else:
-            if len(args.files) != 1:
-                raise RuntimeError('cannot specify multiple netlist XML files')
-            output_filename = args.files[0]
+            # Verilator compilation
+            # (Only supports one source file currently, useful for testing.)
+            if args.compile:
+                if len(args.files) == 0:
+                    raise RuntimeError('no source file specified')
+                if args.output_file == None:
+                    output_filename = next(tempfile._get_candidate_names())
+                else:
+                    output_filename = args.output_file
+                comp = RunVerilator(defs.INSTALL_PREFIX)
+                if comp.run(args.files[0], output_filename) > 0:
+                    raise RuntimeError('error compiling design')
+            else:
+                if len(args.files) == 0:
+                    raise RuntimeError('no netlist XML file specified')
+                if len(args.files) > 1:
+                    raise RuntimeError('cannot specify multiple netlist XML files')
+                output_filename = args.files[0]
 
-        # Create the netlist
-        netlist = Netlist(output_filename)
+            # Create the netlist
+            netlist = Netlist(output_filename)
 
-        # Delete the temporary XML output file.
-        if args.compile and args.output_file == None:
-            os.remove(output_filename)
+            # Delete the temporary XML output file.
+            if args.compile and args.output_file == None:
+                os.remove(output_filename)
+
+        # Save a snapshot of the netlist
+        if args.save_snapshot:
+            netlist.save(args.save_snapshot)
+
+        # Save an image of the netlist
+        if args.save_image:
+            netlist.save_image(args.save_image)
 
         # Dump all names
         if args.dump_names != None:
-            dump_names(netlist.get_named_vertices(args.dump_names), sys.stdout)
+            dump_names(netlist, netlist.get_named_vertices(args.dump_names), sys.stdout)
             return 0
 
         # Dump nets
         if args.dump_nets != None:
-            dump_names(netlist.get_net_vertices(args.dump_nets), sys.stdout)
+            dump_names(netlist, netlist.get_net_vertices(args.dump_nets), sys.stdout)
             return 0
 
         # Dump ports
         if args.dump_ports != None:
-            dump_names(netlist.get_port_vertices(args.dump_ports), sys.stdout)
+            dump_names(netlist, netlist.get_port_vertices(args.dump_ports), sys.stdout)
             return 0
 
         # Dump regs
         if args.dump_regs != None:
-            dump_names(netlist.get_reg_vertices(args.dump_regs), sys.stdout)
+            dump_names(netlist, netlist.get_reg_vertices(args.dump_regs), sys.stdout)
             return 0
 
         # Dump graph dotfile
@@ -265,6 +370,11 @@ def main():
             netlist.dump_dot_file(args.output_file if args.output_file else DEFAULT_DOT_FILE)
             return 0
 
+        # Loops
+        if args.loops:
+            dump_loop_report(netlist, netlist.get_loops(), sys.stdout)
+            return 0
+
         # Point-to-point path
         if args.start_point and args.finish_point:
             waypoints = Waypoints()
@@ -272,9 +382,11 @@ def main():
             waypoints.add_finish_point(args.finish_point)
             [waypoints.add_through_point(point) for point in args.through_points]
             [waypoints.add_avoid_point(point) for point in args.avoid_points]
-            if args.all_paths:
-                path = netlist.get_all_paths(waypoints)
-                dump_path_list_report(netlist, path, sys.stdout)
+            if args.count_paths:
+                print(format_path_count(netlist.count_paths(waypoints)))
+            elif args.all_paths:
+                paths = netlist.iter_paths(waypoints)
+                dump_path_list_report(netlist, paths, sys.stdout)
             else:
                 path = netlist.get_any_path(waypoints)
                 dump_path_report(netlist, path, sys.stdout)
@@ -286,6 +398,12 @@ def main():
                 raise RuntimeError('cannot specify through points with fanout paths')
             if len(args.avoid_points) > 0:
                 raise RuntimeError('cannot specify avoid points with fanout paths')
+            if args.fanout:
+                print(netlist.get_fanout_degree(args.start_point))
+                return 0
+            if args.count_paths:
+                dump_path_count_report(netlist.count_fanout_paths(args.start_point), sys.stdout)
+                return 0
             paths = netlist.get_all_fanout_paths(args.start_point)
             dump_path_list_report(netlist, paths, sys.stdout)
             return 0
@@ -296,6 +414,12 @@ def main():
                 raise RuntimeError('cannot specify through points with fanin paths')
             if len(args.avoid_points) > 0:
                 raise RuntimeError('cannot specify avoid points with fanin paths')
+            if args.fanin:
+                print(netlist.get_fanin_degree(args.finish_point))
+                return 0
+            if args.count_paths:
+                dump_path_count_report(netlist.count_fanin_paths(args.finish_point), sys.stdout)
+                return 0
             paths = netlist.get_all_fanin_paths(args.finish_point)
             dump_path_list_report(netlist, paths, sys.stdout)
             return 0